@@ -0,0 +1,36 @@
+# Пишет OUTPUT с текущим коммитом для bench_record.cpp. Запускается при каждой
+# сборке; файл перезаписывается только при изменении, чтобы не пересобирать
+# bench_record.cpp зря. Незакоммиченные правки дают суффикс -dirty.
+set(commit "unknown")
+if(GIT_EXECUTABLE)
+    execute_process(
+            COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+            WORKING_DIRECTORY ${SOURCE_DIR}
+            OUTPUT_VARIABLE git_commit
+            OUTPUT_STRIP_TRAILING_WHITESPACE
+            RESULT_VARIABLE git_result
+            ERROR_QUIET
+    )
+    if(git_result EQUAL 0)
+        set(commit ${git_commit})
+        execute_process(
+                COMMAND ${GIT_EXECUTABLE} status --porcelain --untracked-files=no
+                WORKING_DIRECTORY ${SOURCE_DIR}
+                OUTPUT_VARIABLE git_status
+                RESULT_VARIABLE git_result
+                ERROR_QUIET
+        )
+        if(NOT git_result EQUAL 0 OR NOT git_status STREQUAL "")
+            set(commit "${commit}-dirty")
+        endif()
+    endif()
+endif()
+
+set(content "#define PARALLEL_BFS_COMMIT \"${commit}\"\n")
+set(old_content "")
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} old_content)
+endif()
+if(NOT old_content STREQUAL content)
+    file(WRITE ${OUTPUT} "${content}")
+endif()
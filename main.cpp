@@ -3,12 +3,50 @@
 #include <chrono>
 #include <iomanip>
 #include <thread>
+#include <atomic>
+#include <cctype>
+#include <stdexcept>
 #include <random>
 #include <algorithm>
 #include <queue>
 #include <cassert>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <filesystem>
+#include <fstream>
 #include "seqbfs.h"
 #include "parbfs.h"
+#include "components.h"
+#include "dynbfs.h"
+#include "query_batch.h"
+#include "seqsssp.h"
+#include "parsssp.h"
+#include "khop.h"
+#include "betweenness.h"
+#include "diameter.h"
+#include "centrality.h"
+#include "partbfs.h"
+#include "graph_file.h"
+#include "semiext.h"
+#include "arena.h"
+#include "csr_graph.h"
+#include "perf_counters.h"
+#include "graph_builder.h"
+#include "grid_bfs.h"
+#include "dobfs.h"
+#include "asyncbfs.h"
+#include "localbfs.h"
+#include "bfs_tree.h"
+#include "bench_record.h"
+#include "filtered_bfs.h"
+#include "bfs_cache.h"
+#include "graph_version.h"
+#include "landmarks.h"
+#include "bfs_profile.h"
+#include "tuning.h"
+#include <parlay/parallel.h>
+#include <parlay/utilities.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -463,68 +501,2862 @@ bool test_small_cube() {
     return distances_correct;
 }
 
+// Компоненты связности
+bool test_connected_components() {
+    std::cout << "\nCONNECTED COMPONENTS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(7);
+
+    for (int graph_num = 0; graph_num < 20; graph_num++) {
+        total++;
+
+        // Несколько случайных кусков, цепочка и изолированные вершины
+        int n = 200 + rng() % 801;
+        std::vector<std::vector<int>> graph(n);
+        int pieces = 1 + rng() % 8;
+        for (int e = 0; e < 2 * n; e++) {
+            int piece = rng() % pieces;
+            int u = rng() % n;
+            int v = rng() % n;
+            if (u % pieces == piece && v % pieces == piece && u != v) {
+                graph[u].push_back(v);
+                graph[v].push_back(u);
+            }
+        }
+        for (int i = n - 50; i < n - 10; i++) {
+            graph[i].push_back(i + 1);
+            graph[i + 1].push_back(i);
+        }
+
+        auto cc = connected_components(graph);
+
+        // Эталон: заливка последовательным BFS
+        std::vector<int> expected(n, -1);
+        int expected_count = 0;
+        for (int v = 0; v < n; v++) {
+            if (expected[v] != -1) continue;
+            auto dist = sequential_bfs(graph, v);
+            for (int u = 0; u < n; u++) {
+                if (dist[u] >= 0) expected[u] = expected_count;
+            }
+            expected_count++;
+        }
+
+        bool correct = cc.component.size() == static_cast<size_t>(n) &&
+                       cc.sizes.size() == static_cast<size_t>(expected_count);
+        std::vector<int> mapping(expected_count, -1);
+        std::vector<size_t> counted(cc.sizes.size(), 0);
+        for (int v = 0; v < n && correct; v++) {
+            int c = cc.component[v];
+            if (c < 0 || c >= static_cast<int>(cc.sizes.size())) {
+                correct = false;
+                break;
+            }
+            if (mapping[expected[v]] == -1) mapping[expected[v]] = c;
+            if (mapping[expected[v]] != c) correct = false;
+            counted[c]++;
+        }
+        if (correct && counted != cc.sizes) correct = false;
+
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: components mismatch at graph " << graph_num << std::endl;
+            break;
+        }
+    }
+
+    // Пустой граф и граф без рёбер
+    total++;
+    {
+        auto empty = connected_components({});
+        auto isolated = connected_components(std::vector<std::vector<int>>(5));
+        bool correct = empty.component.empty() && empty.sizes.empty() &&
+                       isolated.sizes.size() == 5;
+        for (size_t s : isolated.sizes) {
+            if (s != 1) correct = false;
+        }
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: components of trivial graphs" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " component tests passed" << std::endl;
+    return passed == total;
+}
+
+// Поддержка расстояний при изменениях графа
+bool test_dynamic_bfs() {
+    std::cout << "\nDYNAMIC BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(11);
+
+    for (int graph_num = 0; graph_num < 20; graph_num++) {
+        total++;
+
+        int n = 100 + rng() % 401;
+        int avg_degree = 1 + rng() % 4;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v && std::find(graph[u].begin(), graph[u].end(), v) == graph[u].end()) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        int source = rng() % n;
+        dynamic_bfs dyn(graph, source);
+        std::vector<int> before = sequential_bfs(graph, source);
+        bool correct = dyn.distances() == before;
+
+        for (int batch = 0; batch < 10 && correct; batch++) {
+            std::vector<dynamic_bfs::edge> insertions;
+            std::vector<dynamic_bfs::edge> deletions;
+            int batch_size = 1 + rng() % 10;
+            for (int e = 0; e < batch_size; e++) {
+                int u = rng() % n;
+                if (rng() % 2 == 0 && !graph[u].empty()) {
+                    int v = graph[u][rng() % graph[u].size()];
+                    // Удаления применяются до вставок, вставленное в этом же пакете не трогаем
+                    if (std::find(insertions.begin(), insertions.end(), std::make_pair(u, v)) != insertions.end() ||
+                        std::find(insertions.begin(), insertions.end(), std::make_pair(v, u)) != insertions.end()) {
+                        continue;
+                    }
+                    deletions.emplace_back(u, v);
+                    graph[u].erase(std::find(graph[u].begin(), graph[u].end(), v));
+                    graph[v].erase(std::find(graph[v].begin(), graph[v].end(), u));
+                } else {
+                    int v = rng() % n;
+                    if (u != v && std::find(graph[u].begin(), graph[u].end(), v) == graph[u].end()) {
+                        insertions.emplace_back(u, v);
+                        graph[u].push_back(v);
+                        graph[v].push_back(u);
+                    }
+                }
+            }
+
+            auto changed = dyn.apply(insertions, deletions);
+            std::vector<int> after = sequential_bfs(graph, source);
+
+            std::vector<int> expected_changed;
+            for (int v = 0; v < n; v++) {
+                if (before[v] != after[v]) expected_changed.push_back(v);
+            }
+            std::sort(changed.begin(), changed.end());
+
+            if (dyn.distances() != after || changed != expected_changed) {
+                correct = false;
+                std::cout << "Mismatch at graph " << graph_num << ", batch " << batch << std::endl;
+            }
+            before = after;
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            break;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " dynamic BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+// Пакет независимых запросов
+bool test_query_batch() {
+    std::cout << "\nQUERY BATCH" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(5);
+
+    // Несколько компонент разного размера: часть запросов превысит лимит
+    std::vector<std::vector<int>> graph;
+    for (int part = 0; part < 30; part++) {
+        int offset = graph.size();
+        int size = part % 10 == 0 ? 2000 : 20 + rng() % 100;
+        graph.resize(offset + size);
+        for (int v = 1; v < size; v++) {
+            int u = rng() % v;
+            graph[offset + u].push_back(offset + v);
+            graph[offset + v].push_back(offset + u);
+        }
+    }
+    int n = graph.size();
+
+    for (size_t limit : {size_t(1) << 16, size_t(500)}) {
+        total++;
+
+        std::vector<int> sources(200);
+        for (int& s : sources) s = rng() % n;
+
+        batch_stats stats;
+        auto results = bfs_batch(graph, sources, &stats, limit);
+
+        bool correct = results.size() == sources.size() && stats.queries == sources.size();
+        for (size_t i = 0; i < sources.size() && correct; i++) {
+            auto seq = sequential_bfs(graph, sources[i]);
+            std::vector<int> got(n, -1);
+            int prev = 0;
+            for (const auto& [v, d] : results[i]) {
+                if (d < prev) correct = false;
+                prev = d;
+                got[v] = d;
+            }
+            if (got != seq) {
+                correct = false;
+                std::cout << "Mismatch at query " << i << ", source=" << sources[i] << std::endl;
+            }
+        }
+        if (limit < 2000 && stats.large_queries == 0) correct = false;
+
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: query batch with limit " << limit << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " query batch tests passed" << std::endl;
+    return passed == total;
+}
+
+// Delta-stepping против последовательного Дейкстры
+bool test_delta_stepping() {
+    std::cout << "\nDELTA STEPPING" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(13);
+
+    for (int graph_num = 0; graph_num < 30; graph_num++) {
+        total++;
+
+        int n = 50 + rng() % 451;
+        int avg_degree = 1 + rng() % 8;
+        weighted_graph<int> int_graph(n);
+        weighted_graph<double> real_graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u == v) continue;
+                int w = rng() % 100;
+                double rw = std::uniform_real_distribution<double>(0.0, 10.0)(rng);
+                int_graph[u].emplace_back(v, w);
+                int_graph[v].emplace_back(u, w);
+                real_graph[u].emplace_back(v, rw);
+                real_graph[v].emplace_back(u, rw);
+            }
+        }
+
+        int start = rng() % n;
+        bool correct = true;
+
+        auto int_expected = sequential_dijkstra(int_graph, start);
+        for (long long delta : {1LL, 7LL, 16LL, 1000LL}) {
+            if (delta_stepping(int_graph, start, delta) != int_expected) {
+                correct = false;
+                std::cout << "Mismatch at graph " << graph_num << ", integer delta=" << delta << std::endl;
+            }
+        }
+
+        auto real_expected = sequential_dijkstra(real_graph, start);
+        for (double delta : {0.5, 3.0, 100.0}) {
+            auto got = delta_stepping(real_graph, start, delta);
+            for (int i = 0; i < n; i++) {
+                if (std::abs(got[i] - real_expected[i]) > 1e-9) {
+                    correct = false;
+                    std::cout << "Mismatch at graph " << graph_num << ", delta=" << delta
+                              << ", vertex=" << i << std::endl;
+                    break;
+                }
+            }
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            break;
+        }
+    }
+
+    // Единичные веса с delta = 1 дают BFS
+    total++;
+    {
+        auto graph = create_cube_grid(10, 10, 10);
+        weighted_graph<int> unit(graph.size());
+        for (size_t v = 0; v < graph.size(); v++) {
+            for (int u : graph[v]) unit[v].emplace_back(u, 1);
+        }
+        auto bfs = sequential_bfs(graph, 0);
+        auto sssp = delta_stepping(unit, 0, 1);
+        if (std::vector<long long>(bfs.begin(), bfs.end()) == sssp) {
+            passed++;
+        } else {
+            std::cout << "FAIL: unit weights differ from BFS" << std::endl;
+        }
+    }
+
+    // Веса много больше delta: корзины не заводятся до максимального расстояния
+    total++;
+    {
+        std::mt19937 heavy_rng(29);
+        int n = 2000;
+        weighted_graph<int> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < 3; d++) {
+                int v = heavy_rng() % n;
+                int w = d == 0 ? 1000000000 : static_cast<int>(heavy_rng() % 5000);
+                graph[u].emplace_back(v, w);
+                graph[v].emplace_back(u, w);
+            }
+        }
+        auto expected = sequential_dijkstra(graph, 0);
+        bool correct = true;
+        for (long long delta : {1LL, 64LL, 1000LL}) {
+            correct = correct && delta_stepping(graph, 0, delta) == expected;
+        }
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: heavy edges with small delta" << std::endl;
+        }
+    }
+
+    // Неположительная ширина корзины отвергается
+    total++;
+    {
+        weighted_graph<int> int_graph(2);
+        int_graph[0].emplace_back(1, 1);
+        weighted_graph<double> real_graph(2);
+        real_graph[0].emplace_back(1, 1.0);
+
+        int rejected = 0;
+        for (long long delta : {0LL, -5LL}) {
+            try {
+                delta_stepping(int_graph, 0, delta);
+            } catch (const std::invalid_argument&) {
+                rejected++;
+            }
+        }
+        for (double delta : {0.0, -1.0, std::numeric_limits<double>::quiet_NaN()}) {
+            try {
+                delta_stepping(real_graph, 0, delta);
+            } catch (const std::invalid_argument&) {
+                rejected++;
+            }
+        }
+        if (rejected == 5) {
+            passed++;
+        } else {
+            std::cout << "FAIL: only " << rejected << "/5 bad deltas rejected" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " delta-stepping tests passed" << std::endl;
+    return passed == total;
+}
+
+// Обход на k шагов
+bool test_khop() {
+    std::cout << "\nK-HOP BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(17);
+
+    for (int graph_num = 0; graph_num < 20; graph_num++) {
+        total++;
+
+        int n = 100 + rng() % 901;
+        int avg_degree = 1 + rng() % 5;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        // Один объект на все запросы: метки эпох не должны мешать друг другу
+        khop_bfs khop(graph);
+        bool correct = true;
+
+        for (int q = 0; q < 10 && correct; q++) {
+            int start = rng() % n;
+            int k = rng() % 6;
+            size_t limit = q % 2 == 0 ? SIZE_MAX : 1 + rng() % 50;
+            auto seq = sequential_bfs(graph, start);
+
+            size_t within = 0;
+            for (int i = 0; i < n; i++) {
+                if (seq[i] >= 0 && seq[i] <= k) within++;
+            }
+
+            auto res = khop.query(start, k, limit);
+            std::vector<char> seen(n, 0);
+            int prev = 0;
+            for (const auto& [v, d] : res) {
+                if (seen[v] || d != seq[v] || d < prev || d > k) correct = false;
+                seen[v] = 1;
+                prev = d;
+            }
+            if (res.size() != std::min(within, limit)) correct = false;
+            // Все вершины ближе последнего уровня должны попасть в ответ
+            for (int i = 0; i < n && correct; i++) {
+                if (seq[i] >= 0 && seq[i] < prev && !seen[i]) correct = false;
+            }
+
+            if (!correct) {
+                std::cout << "Mismatch at graph " << graph_num << ", start=" << start
+                          << ", k=" << k << std::endl;
+            }
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            break;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " k-hop tests passed" << std::endl;
+    return passed == total;
+}
+
+// Эталонный последовательный Брандес для неориентированного графа
+std::vector<double> reference_betweenness(const std::vector<std::vector<int>>& graph) {
+    int n = graph.size();
+    std::vector<double> bc(n, 0.0);
+    for (int s = 0; s < n; s++) {
+        std::vector<int> dist(n, -1);
+        std::vector<double> sigma(n, 0.0);
+        std::vector<double> delta(n, 0.0);
+        std::vector<int> order;
+        std::queue<int> queue;
+        dist[s] = 0;
+        sigma[s] = 1;
+        queue.push(s);
+        while (!queue.empty()) {
+            int v = queue.front();
+            queue.pop();
+            order.push_back(v);
+            for (int w : graph[v]) {
+                if (dist[w] == -1) {
+                    dist[w] = dist[v] + 1;
+                    queue.push(w);
+                }
+                if (dist[w] == dist[v] + 1) sigma[w] += sigma[v];
+            }
+        }
+        for (int i = order.size() - 1; i >= 0; i--) {
+            int w = order[i];
+            for (int v : graph[w]) {
+                if (dist[v] == dist[w] - 1) delta[v] += sigma[v] / sigma[w] * (1 + delta[w]);
+            }
+            if (w != s) bc[w] += delta[w];
+        }
+    }
+    for (double& x : bc) x /= 2;
+    return bc;
+}
+
+// Центральность по посредничеству
+bool test_betweenness() {
+    std::cout << "\nBETWEENNESS CENTRALITY" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(19);
+
+    for (int graph_num = 0; graph_num < 15; graph_num++) {
+        total++;
+
+        int n = 30 + rng() % 171;
+        int avg_degree = 1 + rng() % 4;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v && std::find(graph[u].begin(), graph[u].end(), v) == graph[u].end()) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        auto expected = reference_betweenness(graph);
+        auto got = betweenness_centrality(graph, n);
+
+        bool correct = true;
+        for (int i = 0; i < n; i++) {
+            if (std::abs(got[i] - expected[i]) > 1e-6 * std::max(1.0, expected[i])) {
+                correct = false;
+                std::cout << "Mismatch at graph " << graph_num << ", vertex=" << i
+                          << ": expected=" << expected[i] << ", got=" << got[i] << std::endl;
+                break;
+            }
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            break;
+        }
+    }
+
+    // Звезда: через центр проходят все пары листьев
+    total++;
+    {
+        int n = 51;
+        std::vector<std::vector<int>> graph(n);
+        for (int i = 1; i < n; i++) {
+            graph[0].push_back(i);
+            graph[i].push_back(0);
+        }
+
+        auto exact = betweenness_centrality(graph, n);
+        auto sampled = betweenness_centrality(graph, 10, 3);
+        double center = (n - 1) * (n - 2) / 2.0;
+        // Листья не лежат ни на одном пути, оценка центра по выборке несмещённая
+        bool correct = std::abs(exact[0] - center) < 1e-9 && sampled[0] > 0 && sampled[0] <= 1.2 * center;
+        for (int i = 1; i < n; i++) {
+            if (exact[i] != 0 || sampled[i] != 0) correct = false;
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: star graph betweenness" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " betweenness tests passed" << std::endl;
+    return passed == total;
+}
+
+// Диаметр и эксцентриситет
+bool test_diameter() {
+    std::cout << "\nDIAMETER" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(23);
+
+    for (int graph_num = 0; graph_num < 20; graph_num++) {
+        total++;
+
+        int n = 50 + rng() % 351;
+        int avg_degree = 1 + rng() % 3;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        // Эталон: эксцентриситеты всех вершин компоненты вершины максимальной степени
+        int center = 0;
+        for (int v = 1; v < n; v++) {
+            if (graph[v].size() > graph[center].size()) center = v;
+        }
+        auto from_center = sequential_bfs(graph, center);
+        int expected = 0;
+        for (int v = 0; v < n; v++) {
+            if (from_center[v] < 0) continue;
+            auto dist = sequential_bfs(graph, v);
+            int ecc = *std::max_element(dist.begin(), dist.end());
+            expected = std::max(expected, ecc);
+            if (v % 7 == 0 && eccentricity(graph, v) != ecc) {
+                std::cout << "Wrong eccentricity at graph " << graph_num << ", vertex=" << v << std::endl;
+                expected = -1;
+                break;
+            }
+        }
+
+        auto exact = estimate_diameter(graph);
+        auto limited = estimate_diameter(graph, 6);
+        bool correct = exact.exact() && exact.lower == expected &&
+                       limited.lower <= expected && expected <= limited.upper && limited.traversals <= 6;
+
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: diameter at graph " << graph_num << ": expected=" << expected
+                      << ", got [" << exact.lower << ", " << exact.upper << "]" << std::endl;
+            break;
+        }
+    }
+
+    // Цепочка и куб: диаметр известен
+    total++;
+    {
+        std::vector<std::vector<int>> chain(1000);
+        for (int i = 0; i + 1 < 1000; i++) {
+            chain[i].push_back(i + 1);
+            chain[i + 1].push_back(i);
+        }
+        auto chain_bounds = estimate_diameter(chain);
+        auto cube_bounds = estimate_diameter(create_cube_grid(5, 5, 5));
+        if (chain_bounds.exact() && chain_bounds.lower == 999 && cube_bounds.exact() && cube_bounds.lower == 12) {
+            passed++;
+            std::cout << "Chain and cube diameters: " << chain_bounds.traversals << " and "
+                      << cube_bounds.traversals << " traversals" << std::endl;
+        } else {
+            std::cout << "FAIL: chain or cube diameter" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " diameter tests passed" << std::endl;
+    return passed == total;
+}
+
+// Гармоническая центральность
+bool test_harmonic_centrality() {
+    std::cout << "\nHARMONIC CENTRALITY" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(29);
+
+    for (int graph_num = 0; graph_num < 15; graph_num++) {
+        total++;
+
+        int n = 50 + rng() % 351;
+        int avg_degree = 1 + rng() % 4;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        std::vector<int> sources;
+        for (int v = 0; v < n; v++) {
+            if (graph_num % 2 == 0 || rng() % 4 == 0) sources.push_back(v);
+        }
+        if (sources.empty()) sources.push_back(0);
+
+        std::vector<double> expected(n, 0.0);
+        for (int s : sources) {
+            auto dist = sequential_bfs(graph, s);
+            for (int v = 0; v < n; v++) {
+                if (dist[v] > 0) expected[v] += 1.0 / dist[v];
+            }
+        }
+        for (double& h : expected) h *= static_cast<double>(n) / sources.size();
+
+        bool correct = true;
+        for (auto mode : {centrality_mode::inter_source, centrality_mode::intra_source}) {
+            auto got = harmonic_centrality(graph, sources, nullptr, mode);
+            for (int v = 0; v < n; v++) {
+                if (std::abs(got[v] - expected[v]) > 1e-9 * std::max(1.0, expected[v])) {
+                    correct = false;
+                    std::cout << "Mismatch at graph " << graph_num << ", vertex=" << v << std::endl;
+                    break;
+                }
+            }
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            break;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " harmonic centrality tests passed" << std::endl;
+    return passed == total;
+}
+
+#ifndef _WIN32
+// Разбиение на процессы с обменом через разделяемую память
+bool test_partitioned_bfs() {
+    std::cout << "\nPARTITIONED BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(31);
+
+    for (int graph_num = 0; graph_num < 8; graph_num++) {
+        total++;
+
+        int n = 100 + rng() % 901;
+        int avg_degree = 1 + rng() % 4;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        int start = rng() % n;
+        int ranks = 1 + graph_num % 4;
+        // Маленькая ёмкость ящика заставляет передавать уровень несколькими пакетами
+        size_t capacity = graph_num % 2 == 0 ? 7 : 1 << 16;
+
+        auto seq = sequential_bfs(graph, start);
+        partition_stats stats;
+        auto part = partitioned_bfs(graph, start, ranks, &stats, capacity);
+
+        int levels = *std::max_element(seq.begin(), seq.end()) + 1;
+        if (part == seq && stats.ranks == ranks && static_cast<int>(stats.levels.size()) == levels) {
+            passed++;
+        } else {
+            std::cout << "FAIL: partitioned BFS at graph " << graph_num << " with " << ranks << " ranks" << std::endl;
+            break;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " partitioned BFS tests passed" << std::endl;
+    return passed == total;
+}
+#endif
+
+// BFS с чтением списков смежности с диска
+bool test_semi_external_bfs() {
+    std::cout << "\nSEMI-EXTERNAL BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(37);
+    std::string path = (std::filesystem::temp_directory_path() / "parbfs_semiext_test.bin").string();
+
+    for (int graph_num = 0; graph_num < 10; graph_num++) {
+        total++;
+
+        int n = 100 + rng() % 901;
+        int avg_degree = 1 + rng() % 4;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                if (u != v) {
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+        write_graph_file(path, graph);
+
+        int start = rng() % n;
+        // Крошечные блоки, чтобы часть из них пропускалась
+        size_t block_bytes = graph_num % 2 == 0 ? 64 : size_t(1) << 20;
+        semi_external_stats stats;
+        auto ext = semi_external_bfs(path, start, &stats, block_bytes);
+        auto seq = sequential_bfs(graph, start);
+
+        size_t skipped = 0;
+        for (const auto& level : stats.levels) {
+            skipped += level.blocks_skipped;
+        }
+
+        bool correct = ext == seq && read_graph_file(path) == graph &&
+                       (block_bytes > 64 || skipped > 0);
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: semi-external BFS at graph " << graph_num << std::endl;
+            break;
+        }
+    }
+    std::filesystem::remove(path);
+
+    std::cout << "\nResults: " << passed << "/" << total << " semi-external BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_huge_page_arena() {
+    std::cout << "\nHUGE PAGE ARENA" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    // Мелкие и крупные блоки, с huge pages и без
+    for (bool huge : {true, false}) {
+        arena::set_huge_pages(huge);
+        for (size_t n : {size_t(0), size_t(1000), size_t(3) << 20}) {
+            total++;
+            arena::array<int> a(n, 7);
+            bool correct = a.size() == n;
+            for (size_t i = 0; i < n; i += 4099) {
+                correct = correct && a[i] == 7;
+            }
+            if (n > 0) {
+                a[n - 1] = 1;
+                correct = correct && a[n - 1] == 1;
+            }
+            arena::array<int> moved = std::move(a);
+            correct = correct && moved.size() == n && a.size() == 0;
+            if (correct) {
+                passed++;
+            } else {
+                std::cout << "FAIL: arena array of " << n << " elements, huge pages " << huge << std::endl;
+            }
+        }
+    }
+    arena::set_huge_pages(true);
+
+    std::mt19937 rng(41);
+    for (int graph_num = 0; graph_num < 10; graph_num++) {
+        total++;
+
+        int n = 1 + rng() % 2000;
+        int avg_degree = rng() % 5;
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            for (int d = 0; d < avg_degree; d++) {
+                int v = rng() % n;
+                graph[u].push_back(v);
+                graph[v].push_back(u);
+            }
+        }
+
+        csr_graph csr(graph);
+        bool correct = csr.size() == graph.size();
+        for (int u = 0; u < n && correct; u++) {
+            auto adj = csr[u];
+            correct = std::vector<int>(adj.begin(), adj.end()) == graph[u];
+        }
+
+        int start = rng() % n;
+        auto expected = sequential_bfs(graph, start);
+        correct = correct && parallel_bfs(csr, start) == expected && parallel_bfs(csr_view(csr), start) == expected;
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: CSR BFS at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " huge page arena tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_graph_builder() {
+    std::cout << "\nGRAPH BUILDER" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(43);
+    for (int graph_num = 0; graph_num < 12; graph_num++) {
+        total++;
+
+        // Мало вершин на много рёбер, чтобы были повторы и петли
+        int n = 1 + rng() % 300;
+        size_t m = rng() % 3000;
+        bool symmetrize = graph_num % 3 != 0;
+        std::vector<std::pair<int, int>> edges(m);
+        for (auto& e : edges) {
+            e = {static_cast<int>(rng() % n), static_cast<int>(rng() % n)};
+        }
+
+        std::vector<std::vector<int>> expected(n);
+        for (auto [u, v] : edges) {
+            if (u == v) continue;
+            expected[u].push_back(v);
+            if (symmetrize) expected[v].push_back(u);
+        }
+        for (auto& adj : expected) {
+            std::sort(adj.begin(), adj.end());
+            adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+        }
+
+        csr_graph graph = build_graph(n, edges, symmetrize);
+        bool correct = graph.size() == static_cast<size_t>(n);
+        for (int u = 0; u < n && correct; u++) {
+            auto adj = graph[u];
+            correct = std::vector<int>(adj.begin(), adj.end()) == expected[u];
+        }
+
+        int start = rng() % n;
+        correct = correct && parallel_bfs(graph, start) == sequential_bfs(expected, start);
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: graph builder at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " graph builder tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_grid_bfs() {
+    std::cout << "\nGRID BFS (" << grid_bfs_kernel() << ")" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    // Ширины вокруг границ слов и векторов, плоские и линейные решётки
+    const int sizes[][3] = {
+        {1, 1, 1}, {7, 1, 1}, {1, 9, 1}, {1, 1, 11}, {64, 3, 2}, {65, 4, 3},
+        {130, 5, 4}, {513, 2, 2}, {20, 20, 1}, {17, 13, 11}, {63, 1, 40}, {30, 30, 30}
+    };
+
+    std::mt19937 rng(47);
+    for (const auto& size : sizes) {
+        auto graph = create_cube_grid(size[0], size[1], size[2]);
+        for (int attempt = 0; attempt < 2; attempt++) {
+            total++;
+            int start = rng() % graph.size();
+            if (grid_bfs(size[0], size[1], size[2], start) == sequential_bfs(graph, start)) {
+                passed++;
+            } else {
+                std::cout << "FAIL: grid " << size[0] << "x" << size[1] << "x" << size[2]
+                          << " from " << start << std::endl;
+            }
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " grid BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_direction_optimizing_bfs() {
+    std::cout << "\nDIRECTION-OPTIMIZING BFS (best kernel: " << simd_level_name(best_simd_level()) << ")" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::vector<simd_level> kernels = {simd_level::scalar};
+    if (best_simd_level() >= simd_level::avx2) kernels.push_back(simd_level::avx2);
+    if (best_simd_level() >= simd_level::avx512) kernels.push_back(simd_level::avx512);
+
+    std::mt19937 rng(53);
+    for (int graph_num = 0; graph_num < 12; graph_num++) {
+        // Плотные случайные графы уходят в шаги снизу вверх, разреженные и
+        // решётка остаются сверху вниз дольше; степени больше 16 проверяют
+        // векторную часть ядер
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 11) {
+            graph = create_cube_grid(15, 12, 10);
+        } else {
+            int n = 1 + rng() % 3000;
+            int avg_degree = graph_num % 2 == 0 ? 1 + rng() % 3 : 10 + rng() % 30;
+            std::vector<std::pair<int, int>> edges;
+            for (int i = 0; i < n * avg_degree / 2; i++) {
+                edges.push_back({static_cast<int>(rng() % n), static_cast<int>(rng() % n)});
+            }
+            csr_graph built = build_graph(n, edges);
+            graph.resize(n);
+            for (int u = 0; u < n; u++) {
+                graph[u].assign(built[u].begin(), built[u].end());
+            }
+        }
+
+        csr_graph csr(graph);
+        int start = rng() % graph.size();
+        auto expected = sequential_bfs(graph, start);
+        for (simd_level kernel : kernels) {
+            total++;
+            if (direction_optimizing_bfs(csr, start, kernel) == expected) {
+                passed++;
+            } else {
+                std::cout << "FAIL: direction-optimizing BFS (" << simd_level_name(kernel)
+                          << ") at graph " << graph_num << std::endl;
+            }
+        }
+    }
+
+    // Больше двух блоков шага снизу вверх: массивы по блокам дополнены до
+    // степени двойки. Кроме расстояний проверяется число шагов и фронт.
+    for (int n : {5000, 70000}) {
+        total++;
+        std::vector<std::pair<int, int>> edges;
+        for (int i = 0; i < n * 3; i++) {
+            edges.push_back({static_cast<int>(rng() % n), static_cast<int>(rng() % n)});
+        }
+        csr_graph csr = build_graph(n, edges);
+        std::vector<std::vector<int>> graph(n);
+        for (int u = 0; u < n; u++) {
+            graph[u].assign(csr[u].begin(), csr[u].end());
+        }
+
+        auto expected = sequential_bfs(graph, 0);
+        int depth = *std::max_element(expected.begin(), expected.end());
+        std::vector<size_t> widths(depth + 1, 0);
+        for (int d : expected) {
+            if (d >= 0) widths[d]++;
+        }
+
+        dobfs_stats stats;
+        bool ok = direction_optimizing_bfs(csr, 0, best_simd_level(), &stats) == expected &&
+                  stats.levels == static_cast<size_t>(depth + 1) && stats.bottom_up_levels >= 2 &&
+                  stats.max_frontier == *std::max_element(widths.begin(), widths.end());
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: direction-optimizing BFS on " << n << " vertices: " << stats.levels << " levels (expected "
+                      << depth + 1 << "), " << stats.bottom_up_levels << " bottom-up, max frontier " << stats.max_frontier << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " direction-optimizing BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_async_bfs() {
+    std::cout << "\nASYNC BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(59);
+    for (int graph_num = 0; graph_num < 12; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(20, 15, 10);
+        } else if (graph_num == 1) {
+            // Цепочка - максимальный диаметр
+            graph.resize(5000);
+            for (int v = 0; v + 1 < 5000; v++) {
+                graph[v].push_back(v + 1);
+                graph[v + 1].push_back(v);
+            }
+        } else {
+            int n = 1 + rng() % 5000;
+            int avg_degree = 1 + rng() % 6;
+            graph.resize(n);
+            for (int u = 0; u < n; u++) {
+                for (int d = 0; d < avg_degree; d++) {
+                    int v = rng() % n;
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        int start = rng() % graph.size();
+        async_stats stats;
+        auto result = async_bfs(graph, start, &stats);
+        auto expected = sequential_bfs(graph, start);
+
+        size_t reached = std::count_if(expected.begin(), expected.end(), [] (int d) { return d >= 0; });
+        bool correct = result == expected && async_bfs(csr_graph(graph), start) == expected &&
+                       stats.relaxations >= reached - 1;
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: async BFS at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " async BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_local_frontier_bfs() {
+    std::cout << "\nLOCAL FRONTIER BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(67);
+    for (int graph_num = 0; graph_num < 12; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(25, 20, 10);
+        } else {
+            // Звёзды дают уровни на много чанков одного потока
+            int n = 1 + rng() % 5000;
+            int avg_degree = graph_num % 3 == 0 ? 0 : 1 + rng() % 5;
+            graph.resize(n);
+            for (int u = 0; u < n; u++) {
+                for (int d = 0; d < avg_degree; d++) {
+                    int v = rng() % n;
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+            if (avg_degree == 0) {
+                for (int v = 1; v < n; v++) {
+                    graph[0].push_back(v);
+                    graph[v].push_back(0);
+                }
+            }
+        }
+
+        int start = rng() % graph.size();
+        auto expected = sequential_bfs(graph, start);
+        if (local_frontier_bfs(graph, start) == expected && local_frontier_bfs(csr_graph(graph), start) == expected) {
+            passed++;
+        } else {
+            std::cout << "FAIL: local frontier BFS at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " local frontier BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+// Эталонное дерево: родитель - минимальный сосед на предыдущем уровне, уровень
+// упорядочен по порядку родителей, затем по спискам смежности
+bfs_tree reference_bfs_tree(const std::vector<std::vector<int>>& graph, int start) {
+    bfs_tree tree;
+    tree.distance = sequential_bfs(graph, start);
+    tree.parent.assign(graph.size(), -1);
+    for (size_t v = 0; v < graph.size(); v++) {
+        for (int u : graph[v]) {
+            if (tree.distance[v] > 0 && tree.distance[u] == tree.distance[v] - 1 &&
+                (tree.parent[v] < 0 || u < tree.parent[v])) {
+                tree.parent[v] = u;
+            }
+        }
+    }
+
+    std::vector<char> placed(graph.size(), 0);
+    tree.order.push_back(start);
+    placed[start] = 1;
+    for (size_t i = 0; i < tree.order.size(); i++) {
+        int u = tree.order[i];
+        for (int k : graph[u]) {
+            if (tree.parent[k] == u && !placed[k]) {
+                placed[k] = 1;
+                tree.order.push_back(k);
+            }
+        }
+    }
+    return tree;
+}
+
+bool test_bfs_tree() {
+    std::cout << "\nBFS TREE" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(71);
+    for (int graph_num = 0; graph_num < 12; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(12, 10, 8);
+        } else {
+            int n = 1 + rng() % 3000;
+            int avg_degree = 1 + rng() % 6;
+            graph.resize(n);
+            for (int u = 0; u < n; u++) {
+                for (int d = 0; d < avg_degree; d++) {
+                    int v = rng() % n;
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        int start = rng() % graph.size();
+        bfs_tree expected = reference_bfs_tree(graph, start);
+        bfs_tree det = parallel_bfs_tree(graph, start);
+        bfs_tree det_csr = parallel_bfs_tree(csr_graph(graph), start);
+        bool correct = det.distance == expected.distance && det.parent == expected.parent &&
+                       det.order == expected.order && det_csr.parent == expected.parent &&
+                       det_csr.order == expected.order;
+
+        // CSR в чужих массивах, как из модуля Python
+        std::vector<uint64_t> offsets(1, 0);
+        std::vector<int> targets;
+        for (const auto& adj : graph) {
+            targets.insert(targets.end(), adj.begin(), adj.end());
+            offsets.push_back(targets.size());
+        }
+        csr_view view(offsets.data(), targets.data(), graph.size());
+        bfs_tree det_view = parallel_bfs_tree(view, start);
+        bfs_tree any_view = parallel_bfs_tree(view, start, false);
+        correct = correct && det_view.distance == expected.distance && det_view.parent == expected.parent &&
+                  det_view.order == expected.order && any_view.distance == expected.distance;
+
+        // Без детерминизма родитель любой соседний на предыдущем уровне
+        bfs_tree any = parallel_bfs_tree(graph, start, false);
+        correct = correct && any.distance == expected.distance && any.order.size() == expected.order.size();
+        for (size_t v = 0; v < graph.size() && correct; v++) {
+            int p = any.parent[v];
+            if (expected.distance[v] <= 0) {
+                correct = p == -1;
+            } else {
+                correct = expected.distance[p] == expected.distance[v] - 1 &&
+                          std::find(graph[v].begin(), graph[v].end(), p) != graph[v].end();
+            }
+        }
+
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: BFS tree at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " BFS tree tests passed" << std::endl;
+    return passed == total;
+}
+
+// Частичный результат: уровни до level найдены полностью, на level + 1 - часть
+bool partial_distances_valid(const bfs_result& result, const std::vector<int>& expected) {
+    for (size_t v = 0; v < expected.size(); v++) {
+        int d = result.distance[v];
+        if (expected[v] >= 0 && expected[v] <= result.level) {
+            if (d != expected[v]) return false;
+        } else if (d != -1 && !(d == expected[v] && d == result.level + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_bfs_options() {
+    std::cout << "\nBFS OPTIONS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    auto cube = create_cube_grid(30, 30, 30);
+    csr_graph cube_csr(cube);
+    auto expected = sequential_bfs(cube, 0);
+    int max_level = *std::max_element(expected.begin(), expected.end());
+
+    // Без прерывания: полный результат и прогресс по каждому уровню
+    {
+        total++;
+        std::vector<bfs_progress> progress;
+        bfs_options options;
+        options.on_level = [&progress] (const bfs_progress& p) { progress.push_back(p); };
+        options.check_every_edges = 100;
+        bfs_result result = parallel_bfs(cube, 0, options);
+
+        bool correct = result.complete() && result.distance == expected && result.level == max_level &&
+                       progress.size() == static_cast<size_t>(max_level) + 1 &&
+                       progress.back().reached == cube.size();
+        for (size_t l = 0; l < progress.size() && correct; l++) {
+            correct = progress[l].level == static_cast<int>(l) &&
+                      progress[l].frontier_size == static_cast<size_t>(std::count(expected.begin(), expected.end(), l));
+        }
+        if (correct) {
+            passed++;
+        } else {
+            std::cout << "FAIL: uninterrupted BFS with options" << std::endl;
+        }
+    }
+
+    // Отмена из обратного вызова на границе уровня
+    for (int cancel_level : {0, 5, 40}) {
+        total++;
+        std::atomic<bool> cancel(false);
+        bfs_options options;
+        options.cancel = &cancel;
+        options.on_level = [&cancel, cancel_level] (const bfs_progress& p) {
+            if (p.level == cancel_level) cancel.store(true);
+        };
+        bfs_result result = parallel_bfs(cube_csr, 0, options);
+
+        if (result.status == bfs_status::cancelled && result.level == cancel_level &&
+            partial_distances_valid(result, expected)) {
+            passed++;
+        } else {
+            std::cout << "FAIL: cancel at level " << cancel_level << std::endl;
+        }
+    }
+
+    // Истёкший срок: только стартовая вершина
+    {
+        total++;
+        bfs_options options;
+        options.deadline = std::chrono::steady_clock::now();
+        bfs_result result = parallel_bfs(cube, 0, options);
+        if (result.status == bfs_status::deadline_exceeded && result.level == 0 && result.distance[0] == 0 &&
+            std::count(result.distance.begin(), result.distance.end(), -1) == static_cast<long>(cube.size()) - 1) {
+            passed++;
+        } else {
+            std::cout << "FAIL: expired deadline" << std::endl;
+        }
+    }
+
+    // Отмена внутри уровня: токен взводится другим потоком, результат
+    // любого момента остановки должен быть согласованным
+    for (int attempt = 0; attempt < 3; attempt++) {
+        total++;
+        std::atomic<bool> cancel(false);
+        bfs_options options;
+        options.cancel = &cancel;
+        options.check_every_edges = 64;
+        std::thread canceller([&cancel, attempt] {
+            std::this_thread::sleep_for(std::chrono::microseconds(200 * attempt));
+            cancel.store(true);
+        });
+        bfs_result result = parallel_bfs(cube_csr, 0, options);
+        canceller.join();
+
+        bool consistent = result.complete() ? result.distance == expected
+                                            : result.status == bfs_status::cancelled &&
+                                              partial_distances_valid(result, expected);
+        if (consistent) {
+            passed++;
+        } else {
+            std::cout << "FAIL: cancel during traversal, attempt " << attempt << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " BFS options tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_bench_record() {
+    std::cout << "\nBENCH RECORD" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::string path = (std::filesystem::temp_directory_path() / "parbfs_bench_test.jsonl").string();
+    std::filesystem::remove(path);
+
+    bench_run before = bench_run::current();
+    before.mode = "all";
+    bench_run after = before;
+    std::mt19937 rng(73);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (int i = 0; i < 10; i++) {
+        // Стабильная метрика выросла на 10%, шумная - на 2% при разбросе 20%,
+        // третья ускорилась
+        before.add("stable \"ms\"", 100 + noise(rng));
+        after.add("stable \"ms\"", 110 + noise(rng));
+        before.add("noisy", 100 + 20 * noise(rng));
+        after.add("noisy", 102 + 20 * noise(rng));
+        before.add("faster", 50 + noise(rng));
+        after.add("faster", 40 + noise(rng));
+    }
+    after.add("single", 1.0);
+    before.add("single", 2.0);
+    append_bench_run(path, before);
+    append_bench_run(path, after);
+
+    auto runs = read_bench_runs(path);
+    total++;
+    if (runs.size() == 2 && runs[0].host == before.host && runs[1].commit == after.commit &&
+        runs[0].metrics == before.metrics && runs[1].metrics == after.metrics) {
+        passed++;
+    } else {
+        std::cout << "FAIL: bench runs do not round-trip" << std::endl;
+    }
+
+    auto comparison = compare_bench_runs(runs[0], runs[1]);
+    auto find = [&comparison] (const std::string& metric) {
+        return *std::find_if(comparison.begin(), comparison.end(),
+                             [&metric] (const metric_comparison& c) { return c.metric == metric; });
+    };
+    total += 4;
+    if (comparison.size() == 4) {
+        if (find("stable \"ms\"").regression) passed++;
+        else std::cout << "FAIL: stable regression not flagged" << std::endl;
+        if (!find("noisy").regression && !find("noisy").improvement) passed++;
+        else std::cout << "FAIL: noise flagged as a change" << std::endl;
+        if (find("faster").improvement && !find("faster").regression) passed++;
+        else std::cout << "FAIL: improvement not detected" << std::endl;
+        if (!find("single").regression && !find("single").improvement) passed++;
+        else std::cout << "FAIL: single samples judged significant" << std::endl;
+    } else {
+        std::cout << "FAIL: expected 4 compared metrics, got " << comparison.size() << std::endl;
+    }
+    std::filesystem::remove(path);
+
+    std::cout << "\nResults: " << passed << "/" << total << " bench record tests passed" << std::endl;
+    return passed == total;
+}
+
+// Замеры текущего запуска для --record, null без него
+bench_run* recorded_run = nullptr;
+
+void record(std::string metric, double value) {
+    if (!recorded_run) return;
+    for (char& c : metric) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    recorded_run->add(metric, value);
+}
+
+// speed_measure compare <file> [before after]: сравнение двух запусков из
+// файла (номера строк, отрицательные - с конца, по умолчанию -2 и -1)
+int compare_command(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        std::cout << "Usage: speed_measure compare <results.jsonl> [before after]" << std::endl;
+        return 1;
+    }
+    auto runs = read_bench_runs(args[1]);
+    auto pick = [&runs] (const std::string& arg) -> const bench_run& {
+        long long i = std::stoll(arg);
+        if (i < 0) i += static_cast<long long>(runs.size());
+        if (i < 0 || i >= static_cast<long long>(runs.size())) {
+            throw std::out_of_range("no run " + arg + " in " + std::to_string(runs.size()) + " runs");
+        }
+        return runs[i];
+    };
+    const bench_run& before = pick(args.size() > 3 ? args[2] : "-2");
+    const bench_run& after = pick(args.size() > 3 ? args[3] : "-1");
+
+    for (const bench_run* run : {&before, &after}) {
+        std::cout << (run == &before ? "Before: " : "After:  ") << run->mode << ", " << run->timestamp << ", commit "
+                  << run->commit << ", " << run->host << " (" << run->cpu << ", " << run->threads << " threads), "
+                  << run->compiler << std::endl;
+    }
+    if (before.host != after.host || before.threads != after.threads) {
+        std::cout << "Warning: runs come from different machines or thread counts" << std::endl;
+    }
+
+    int regressions = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& c : compare_bench_runs(before, after)) {
+        std::cout << "  " << std::left << std::setw(48) << c.metric << std::right
+                  << std::setw(10) << c.mean_before << " -> " << std::setw(10) << c.mean_after
+                  << "  diff 95% CI [" << c.diff_low << ", " << c.diff_high << "]"
+                  << (c.regression ? "  REGRESSION" : c.improvement ? "  improved" : "") << std::endl;
+        regressions += c.regression;
+    }
+    std::cout << regressions << " significant regressions" << std::endl;
+    return regressions > 0 ? 2 : 0;
+}
+
+// Подграф явной копией: остаются рёбра между разрешёнными вершинами, прошедшие фильтр
+template <typename VertexFilter, typename EdgeFilter>
+std::vector<std::vector<int>> copy_subgraph(const std::vector<std::vector<int>>& graph,
+                                            const VertexFilter& allowed, const EdgeFilter& edge_allowed) {
+    std::vector<std::vector<int>> sub(graph.size());
+    for (size_t u = 0; u < graph.size(); u++) {
+        if (!allowed(u)) continue;
+        for (size_t j = 0; j < graph[u].size(); j++) {
+            int v = graph[u][j];
+            if (allowed(v) && edge_allowed(u, v, j)) sub[u].push_back(v);
+        }
+    }
+    return sub;
+}
+
+bool test_filtered_bfs() {
+    std::cout << "\nFILTERED BFS" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(71);
+    for (int graph_num = 0; graph_num < 12; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(25, 20, 10);
+        } else {
+            int n = 1 + rng() % 5000;
+            int avg_degree = 1 + rng() % 5;
+            graph.resize(n);
+            for (int u = 0; u < n; u++) {
+                for (int d = 0; d < avg_degree; d++) {
+                    int v = rng() % n;
+                    graph[u].push_back(v);
+                    graph[v].push_back(u);
+                }
+            }
+        }
+
+        size_t n = graph.size();
+        vertex_mask mask(n);
+        for (size_t v = 0; v < n; v++) {
+            if (rng() % 10 == 0) mask.exclude(v);
+        }
+        // Изредка разрешаем обратно, чтобы проверить include
+        for (size_t v = 0; v < n; v += 13) mask.include(v);
+        int start = rng() % n;
+
+        // Несимметричный фильтр: зависит от номера ребра в списке смежности
+        auto edge_filter = [] (size_t from, size_t to, size_t j) { return (from + to + j) % 5 != 0; };
+        csr_graph csr(graph);
+
+        bool ok = filtered_bfs(graph, start) == sequential_bfs(graph, start) &&
+                  filtered_bfs(csr, start) == sequential_bfs(graph, start);
+
+        std::vector<int> expected_mask(n, -1);
+        std::vector<int> expected_both(n, -1);
+        if (mask(start)) {
+            expected_mask = sequential_bfs(copy_subgraph(graph, mask, all_edges()), start);
+            expected_both = sequential_bfs(copy_subgraph(graph, mask, edge_filter), start);
+        }
+        ok = ok && filtered_bfs(graph, start, mask) == expected_mask &&
+             filtered_bfs(csr, start, mask) == expected_mask &&
+             filtered_bfs(graph, start, mask, edge_filter) == expected_both &&
+             filtered_bfs(csr, start, mask, edge_filter) == expected_both;
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: filtered BFS at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " filtered BFS tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_bfs_cache() {
+    std::cout << "\nBFS CACHE" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    // Упаковка на глубинах для всех ширин
+    for (int length : {10, 300, 70000}) {
+        total++;
+        std::vector<std::vector<int>> chain(length + 5);
+        for (int v = 0; v + 1 < length; v++) {
+            chain[v].push_back(v + 1);
+            chain[v + 1].push_back(v);
+        }
+        auto expected = sequential_bfs(chain, 0);
+        std::vector<int> unpacked;
+        packed_levels packed = packed_levels::pack(expected);
+        packed.unpack(unpacked);
+        unsigned width = length < 255 ? 1 : length < 65535 ? 2 : 4;
+        if (unpacked == expected && packed.width == width && packed.data.size() == expected.size() * width) {
+            passed++;
+        } else {
+            std::cout << "FAIL: packing of chain " << length << std::endl;
+        }
+    }
+
+    // Попадания и промахи
+    {
+        total++;
+        auto graph = create_cube_grid(20, 20, 20);
+        csr_graph csr(graph);
+        uint64_t version = new_graph_version();
+        bfs_cache cache(size_t(1) << 20);
+        bool ok = cached_bfs(cache, csr, version, 5) == sequential_bfs(graph, 5) &&
+                  cached_bfs(cache, csr, version, 5) == sequential_bfs(graph, 5) &&
+                  cached_bfs(cache, graph, version, 7) == sequential_bfs(graph, 7);
+        std::vector<int> other;
+        ok = ok && !cache.lookup(bfs_cache_key{version, 5, 1}, other) &&
+             !cache.lookup(bfs_cache_key{version + 1, 5, 0}, other);
+        bfs_cache_stats stats = cache.stats();
+        if (ok && stats.hits == 1 && stats.misses == 4 && stats.entries == 2 &&
+            stats.bytes == 2 * packed_levels::pack(sequential_bfs(graph, 5)).bytes()) {
+            passed++;
+        } else {
+            std::cout << "FAIL: cache hits and misses" << std::endl;
+        }
+    }
+
+    // Бюджет: вытесняется давно не запрошенный
+    {
+        total++;
+        auto graph = create_cube_grid(10, 10, 10);
+        uint64_t version = new_graph_version();
+        size_t entry_bytes = packed_levels::pack(sequential_bfs(graph, 0)).bytes();
+        bfs_cache cache(3 * entry_bytes);
+        for (int s = 0; s < 3; s++) {
+            cached_bfs(cache, graph, version, s);
+        }
+        std::vector<int> d;
+        cache.lookup(bfs_cache_key{version, 0, 0}, d);
+        cached_bfs(cache, graph, version, 3);
+        bfs_cache_stats stats = cache.stats();
+        bool ok = stats.entries == 3 && stats.evictions == 1 && stats.bytes <= cache.budget() &&
+                  cache.lookup(bfs_cache_key{version, 0, 0}, d) && !cache.lookup(bfs_cache_key{version, 1, 0}, d) &&
+                  cache.lookup(bfs_cache_key{version, 3, 0}, d) && d == sequential_bfs(graph, 3);
+
+        // Больше бюджета - не сохраняется
+        bfs_cache tiny(entry_bytes / 2);
+        cached_bfs(tiny, graph, version, 0);
+        ok = ok && tiny.stats().entries == 0;
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: cache eviction" << std::endl;
+        }
+    }
+
+    // Изменение графа
+    {
+        total++;
+        auto graph = create_cube_grid(10, 10, 10);
+        dynamic_bfs dyn(graph, 0);
+        bfs_cache cache(size_t(1) << 20);
+        uint64_t old_version = dyn.graph_version();
+        cached_bfs(cache, dyn.graph(), old_version, 0);
+
+        dyn.apply({{0, 999}}, {});
+        uint64_t new_version = dyn.graph_version();
+        dyn.apply({{0, 999}}, {});
+        bool ok = new_version != old_version && dyn.graph_version() == new_version;
+        cache.invalidate(old_version);
+        ok = ok && cache.stats().entries == 0 &&
+             cached_bfs(cache, dyn.graph(), dyn.graph_version(), 0) == sequential_bfs(dyn.graph(), 0);
+
+        // Результат старой версии, досчитанный после invalidate
+        cache.insert(bfs_cache_key{old_version, 1, 0}, sequential_bfs(graph, 1));
+        std::vector<int> d;
+        ok = ok && !cache.lookup(bfs_cache_key{old_version, 1, 0}, d) && cache.stats().entries == 1;
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: cache invalidation" << std::endl;
+        }
+    }
+
+    // Общий кэш для двух графов одного размера
+    {
+        total++;
+        auto grid = create_cube_grid(10, 10, 10);
+        std::vector<std::vector<int>> chain(grid.size());
+        for (size_t v = 0; v + 1 < chain.size(); v++) {
+            chain[v].push_back(static_cast<int>(v + 1));
+            chain[v + 1].push_back(static_cast<int>(v));
+        }
+        dynamic_bfs dyn(chain, 0);
+        uint64_t grid_version = new_graph_version();
+        bfs_cache cache(size_t(1) << 20);
+        bool ok = grid_version != dyn.graph_version() &&
+                  cached_bfs(cache, grid, grid_version, 0) == sequential_bfs(grid, 0) &&
+                  cached_bfs(cache, chain, dyn.graph_version(), 0) == sequential_bfs(chain, 0) &&
+                  cached_bfs(cache, grid, grid_version, 0) == sequential_bfs(grid, 0);
+
+        // Изменение одного графа не трогает результаты другого
+        uint64_t old_version = dyn.graph_version();
+        dyn.apply({{0, 999}}, {});
+        cache.invalidate(old_version);
+        std::vector<int> d;
+        ok = ok && cache.lookup(bfs_cache_key{grid_version, 0, 0}, d) && d == sequential_bfs(grid, 0) &&
+             cached_bfs(cache, dyn.graph(), dyn.graph_version(), 0) == sequential_bfs(dyn.graph(), 0);
+
+        bfs_cache_stats stats = cache.stats();
+        if (ok && stats.hits == 2 && stats.misses == 3 && stats.entries == 2) {
+            passed++;
+        } else {
+            std::cout << "FAIL: cache shared between graphs" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " BFS cache tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_landmark_index() {
+    std::cout << "\nLANDMARK INDEX" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(73);
+    for (int graph_num = 0; graph_num < 10; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(8, 7, 6);
+        } else {
+            // Разреженные графы распадаются на несколько компонент
+            int n = 1 + rng() % 400;
+            int m = rng() % (2 * n);
+            graph.resize(n);
+            for (int e = 0; e < m; e++) {
+                int u = rng() % n;
+                int v = rng() % n;
+                if (u == v) continue;
+                graph[u].push_back(v);
+                graph[v].push_back(u);
+            }
+        }
+
+        size_t n = graph.size();
+        landmark_index sequential(graph, 1);
+        landmark_build_stats stats;
+        landmark_index batched(csr_graph(graph), 16, &stats);
+
+        bool ok = stats.labels == batched.num_labels() && batched.num_labels() >= sequential.num_labels();
+        for (size_t s = 0; s < n && ok; s++) {
+            auto expected = sequential_bfs(graph, s);
+            for (size_t t = 0; t < n; t++) {
+                if (sequential.distance(s, t) != expected[t] || batched.distance(s, t) != expected[t]) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: landmark index at graph " << graph_num << std::endl;
+        }
+    }
+
+    // Сохранение и загрузка
+    {
+        total++;
+        auto graph = create_cube_grid(10, 10, 5);
+        landmark_index index(graph);
+        std::string path = (std::filesystem::temp_directory_path() / "parbfs_landmarks_test.bin").string();
+        write_landmark_index(path, index);
+        landmark_index loaded = read_landmark_index(path);
+
+        bool ok = loaded.rank() == index.rank() && loaded.offsets() == index.offsets() &&
+                  loaded.num_labels() == index.num_labels() && loaded.distance(0, 499) == 9 + 9 + 4;
+
+        // Обрезанный файл
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+        try {
+            read_landmark_index(path);
+            ok = false;
+        } catch (const std::runtime_error&) {
+        }
+        std::filesystem::remove(path);
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: landmark index save and load" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " landmark index tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_bfs_profile() {
+    std::cout << "\nBFS PROFILE" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    std::mt19937 rng(79);
+    for (int graph_num = 0; graph_num < 6; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(15, 10, 5);
+        } else {
+            int n = 1 + rng() % 3000;
+            graph.resize(n);
+            for (int e = 0; e < 2 * n; e++) {
+                int u = rng() % n;
+                int v = rng() % n;
+                graph[u].push_back(v);
+                graph[v].push_back(u);
+            }
+        }
+
+        int start = rng() % graph.size();
+        auto expected = sequential_bfs(graph, start);
+        bfs_profile profile;
+        bool ok = profiled_bfs(csr_graph(graph), start, profile) == expected &&
+                  profiled_bfs(graph, start, profile) == expected;
+
+        // Уровень на каждое расстояние, фронты покрывают все достижимые
+        int depth = *std::max_element(expected.begin(), expected.end());
+        size_t reached = std::count_if(expected.begin(), expected.end(), [] (int d) { return d >= 0; });
+        size_t fronts = 0;
+        for (const level_profile& level : profile.levels) {
+            fronts += level.frontier_size;
+            ok = ok && level.expand.values.size() == profile.events.size() && level.expand.seconds >= 0;
+        }
+        ok = ok && profile.levels.size() == static_cast<size_t>(depth + 1) && fronts == reached &&
+             profile.available.size() == profile.events.size();
+
+        // Без счётчиков значения нулевые, со счётчиками циклы идут
+        phase_sample expand = profile.total(&level_profile::expand);
+        for (size_t i = 0; i < profile.events.size(); i++) {
+            if (!profile.available[i]) ok = ok && expand.values[i] == 0;
+            if (profile.available[i] && profile.events[i] == perf_counter::event::cycles) ok = ok && expand.values[i] > 0;
+        }
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: profiled BFS at graph " << graph_num << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " BFS profile tests passed" << std::endl;
+    return passed == total;
+}
+
+bool test_tuning() {
+    std::cout << "\nTUNING" << std::endl;
+    int passed = 0;
+    int total = 0;
+
+    bfs_tuning saved = current_tuning();
+
+    // Крайние значения параметров не меняют результатов
+    std::vector<bfs_tuning> tunings(4);
+    tunings[0].expand_grain = tunings[0].scan_grain = tunings[0].scatter_grain = 1;
+    tunings[1].sequential_below = size_t(1) << 30;
+    tunings[1].scan_grain = size_t(1) << 30;
+    tunings[2].dobfs_alpha = 1;
+    tunings[2].dobfs_beta = 1;
+    tunings[3].expand_grain = 100000;
+    tunings[3].dobfs_alpha = 1000;
+    tunings[3].dobfs_beta = 0;
+
+    std::mt19937 rng(83);
+    for (int graph_num = 0; graph_num < 8; graph_num++) {
+        total++;
+
+        std::vector<std::vector<int>> graph;
+        if (graph_num == 0) {
+            graph = create_cube_grid(20, 15, 10);
+        } else {
+            int n = 1 + rng() % 5000;
+            graph.resize(n);
+            for (int e = 0; e < 3 * n; e++) {
+                int u = rng() % n;
+                int v = rng() % n;
+                graph[u].push_back(v);
+                graph[v].push_back(u);
+            }
+        }
+        csr_graph csr(graph);
+        int start = rng() % graph.size();
+        auto expected = sequential_bfs(graph, start);
+        size_t components = connected_components(graph).sizes.size();
+
+        bool ok = true;
+        for (const bfs_tuning& tuning : tunings) {
+            scoped_tuning scope(tuning);
+            ok = ok && parallel_bfs(graph, start) == expected && parallel_bfs(csr, start) == expected &&
+                 direction_optimizing_bfs(csr, start) == expected &&
+                 connected_components(graph).sizes.size() == components;
+        }
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: BFS under tuning at graph " << graph_num << std::endl;
+        }
+    }
+
+    // Подмена видна только своему потоку и снимается при исключении
+    {
+        total++;
+        bool ok = true;
+        try {
+            scoped_tuning outer(tunings[0]);
+            {
+                scoped_tuning inner(tunings[3]);
+                ok = ok && current_tuning() == tunings[3];
+            }
+            ok = ok && current_tuning() == tunings[0];
+            bool other_thread_default = false;
+            std::thread([&] { other_thread_default = current_tuning() == saved; }).join();
+            ok = ok && other_thread_default;
+            throw std::runtime_error("unwind");
+        } catch (const std::runtime_error&) {
+        }
+        ok = ok && current_tuning() == saved;
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: scoped tuning" << std::endl;
+        }
+    }
+
+    // Файл профиля
+    {
+        total++;
+        std::string path = (std::filesystem::temp_directory_path() / "parbfs_tuning_test" / "host.tuning").string();
+        save_tuning(path, tunings[0]);
+        bool ok = load_tuning(path) == tunings[0];
+
+        std::ofstream(path) << "# comment\nscan_grain 512\nfuture_key 7\n";
+        bfs_tuning expected;
+        expected.scan_grain = 512;
+        ok = ok && load_tuning(path) == expected;
+
+        std::ofstream(path) << "scan_grain many\n";
+        try {
+            load_tuning(path);
+            ok = false;
+        } catch (const std::runtime_error&) {
+        }
+        std::filesystem::remove_all(std::filesystem::path(path).parent_path());
+
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: tuning file" << std::endl;
+        }
+    }
+
+    // Подбор на выборке
+    {
+        total++;
+        csr_graph graph(create_cube_grid(30, 30, 30));
+        autotune_options options;
+        options.sample_vertices = 5000;
+        options.runs = 1;
+
+        // Обходы в другом потоке во время подбора видят прежние параметры
+        std::atomic<bool> tuning_done(false);
+        bool other_thread_default = true;
+        std::thread reader([&] {
+            while (!tuning_done.load()) {
+                other_thread_default = other_thread_default && current_tuning() == saved;
+                parallel_bfs(graph, 0);
+            }
+        });
+        autotune_result result = autotune(graph, options);
+        tuning_done.store(true);
+        reader.join();
+
+        bool ok = result.sample_vertices == 5000 && result.default_ms > 0 && result.tuned_ms > 0 &&
+                  current_tuning() == saved && other_thread_default &&
+                  result.tuning.dobfs_alpha > 0 && result.tuning.dobfs_beta > 0;
+        if (ok) {
+            passed++;
+        } else {
+            std::cout << "FAIL: autotune" << std::endl;
+        }
+    }
+
+    std::cout << "\nResults: " << passed << "/" << total << " tuning tests passed" << std::endl;
+    return passed == total;
+}
+
 // Тест производительности на большом кубе
 void performance_test() {
     std::cout << "\nPERFORMANCE TEST" << std::endl;
 
-    std::cout << "\nCreating 300x300x300 cube graph" << std::endl;
+    std::cout << "\nCreating 300x300x300 cube graph" << std::endl;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto graph = create_cube_grid(300, 300, 300);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto create_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    int start = 0;
+    std::cout << "Graph created: " << graph.size() << " vertices" << std::endl;
+    std::cout << "Creation time: " << create_duration.count() << " ms" << std::endl;
+
+    // Тестирование последовательного BFS
+    std::cout << "\nTesting Sequential BFS (5 runs)" << std::endl;
+    std::vector<long long> seq_times;
+
+    for (int run = 0; run < 5; run++) {
+        start_time = std::chrono::high_resolution_clock::now();
+        auto seq_result = sequential_bfs(graph, start);
+        end_time = std::chrono::high_resolution_clock::now();
+
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        seq_times.push_back(duration.count());
+        record("sequential_bfs_ms", duration.count());
+
+        std::cout << "  Run " << (run + 1) << ": " << duration.count() << " ms" << std::endl;
+    }
+
+    long long avg_seq = std::accumulate(seq_times.begin(), seq_times.end(), 0LL) / seq_times.size();
+    std::cout << "Average sequential time: " << avg_seq << " ms" << std::endl;
+
+    std::cout << "\nTesting Parallel BFS (5 runs)" << std::endl;
+    std::vector<long long> par_times;
+
+    for (int run = 0; run < 5; run++) {
+        start_time = std::chrono::high_resolution_clock::now();
+        auto par_result = parallel_bfs(graph, start);
+        end_time = std::chrono::high_resolution_clock::now();
+
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        par_times.push_back(duration.count());
+        record("parallel_bfs_ms", duration.count());
+
+        std::cout << "  Run " << (run + 1) << ": " << duration.count() << " ms" << std::endl;
+    }
+
+    long long avg_par = std::accumulate(par_times.begin(), par_times.end(), 0LL) / par_times.size();
+    std::cout << "Average parallel time: " << avg_par << " ms" << std::endl;
+
+    std::cout << "\nPERFORMANCE RESULTS" << std::endl;
+    std::cout << "Sequential BFS: " << avg_seq << " ms" << std::endl;
+    std::cout << "Parallel BFS:   " << avg_par << " ms" << std::endl;
+
+
+    double speedup = static_cast<double>(avg_seq) / avg_par;
+    std::cout << "Speedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
+
+}
+
+// Пропускная способность множества маленьких запросов
+void query_throughput_test() {
+    std::cout << "\nQUERY THROUGHPUT TEST" << std::endl;
+
+    // Тысячи маленьких решёток и одна большая
+    std::vector<std::vector<int>> graph;
+    auto add_grid = [&graph] (int size) {
+        int offset = graph.size();
+        graph.resize(offset + size * size);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                int idx = offset + x + y * size;
+                if (x > 0) graph[idx].push_back(idx - 1);
+                if (x < size - 1) graph[idx].push_back(idx + 1);
+                if (y > 0) graph[idx].push_back(idx - size);
+                if (y < size - 1) graph[idx].push_back(idx + size);
+            }
+        }
+    };
+    for (int i = 0; i < 2000; i++) {
+        add_grid(20);
+    }
+    add_grid(1000);
+    int n = graph.size();
+    std::cout << "Graph created: " << n << " vertices" << std::endl;
+
+    std::mt19937 rng(1);
+    std::vector<int> sources(2000);
+    for (int& s : sources) s = rng() % (2000 * 400);
+    sources[0] = n - 1;
+
     auto start_time = std::chrono::high_resolution_clock::now();
-    auto graph = create_cube_grid(300, 300, 300);
+    for (int s : sources) {
+        auto res = parallel_bfs(graph, s);
+    }
     auto end_time = std::chrono::high_resolution_clock::now();
-    auto create_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    double one_by_one = std::chrono::duration<double>(end_time - start_time).count();
+
+    batch_stats stats;
+    bfs_batch(graph, sources, &stats);
+
+    std::cout << "\nQUERY THROUGHPUT RESULTS" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "parallel_bfs one by one: " << sources.size() / one_by_one << " queries/s" << std::endl;
+    std::cout << "bfs_batch:               " << stats.queries_per_sec << " queries/s ("
+              << stats.large_queries << " large)" << std::endl;
+    std::cout << std::setprecision(3);
+    std::cout << "Latency p50: " << stats.p50_ms << " ms, p99: " << stats.p99_ms
+              << " ms, max: " << stats.max_ms << " ms" << std::endl;
+}
 
-    int start = 0;
+// Пропускная способность центральности по источникам
+void centrality_throughput_test() {
+    std::cout << "\nCENTRALITY THROUGHPUT TEST" << std::endl;
+
+    std::mt19937 rng(2);
+    for (int size : {20, 100}) {
+        auto graph = create_cube_grid(size, size, size);
+        int n = graph.size();
+        std::vector<int> sources(size == 20 ? 2000 : 20);
+        for (int& s : sources) s = rng() % n;
+
+        std::cout << "\nCube " << size << "^3, " << sources.size() << " sources" << std::endl;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<double> sums(n, 0.0);
+        for (int s : sources) {
+            auto dist = parallel_bfs(graph, s);
+            for (int v = 0; v < n; v++) {
+                if (dist[v] > 0) sums[v] += 1.0 / dist[v];
+            }
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double baseline = std::chrono::duration<double>(end_time - start_time).count();
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "parallel_bfs per source: " << sources.size() / baseline << " sources/s" << std::endl;
+
+        for (auto mode : {centrality_mode::inter_source, centrality_mode::intra_source}) {
+            centrality_stats stats;
+            harmonic_centrality(graph, sources, &stats, mode);
+            std::cout << (mode == centrality_mode::inter_source ? "inter-source:            "
+                                                                : "intra-source:            ")
+                      << stats.sources_per_sec << " sources/s" << std::endl;
+        }
+    }
+}
+
+#ifndef _WIN32
+// Объём обмена и дисбаланс разбиения по уровням
+void partitioned_test() {
+    std::cout << "\nPARTITIONED BFS TEST" << std::endl;
+
+    auto graph = create_cube_grid(100, 100, 100);
     std::cout << "Graph created: " << graph.size() << " vertices" << std::endl;
-    std::cout << "Creation time: " << create_duration.count() << " ms" << std::endl;
 
-    // Тестирование последовательного BFS
-    std::cout << "\nTesting Sequential BFS (5 runs)" << std::endl;
-    std::vector<long long> seq_times;
+    for (int ranks : {2, 4, 8}) {
+        partition_stats stats;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        partitioned_bfs(graph, 0, ranks, &stats);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
-    for (int run = 0; run < 5; run++) {
+        double max_imbalance = 0;
+        for (const auto& level : stats.levels) {
+            max_imbalance = std::max(max_imbalance, level.imbalance);
+        }
+
+        std::cout << "\n" << ranks << " ranks: " << duration.count() << " ms, "
+                  << stats.levels.size() << " levels, " << stats.total_bytes / 1024 << " KiB exchanged, "
+                  << "max imbalance " << std::fixed << std::setprecision(2) << max_imbalance << std::endl;
+        for (size_t l = 0; l < stats.levels.size(); l += 50) {
+            const auto& level = stats.levels[l];
+            std::cout << "  Level " << l << ": frontier " << level.frontier << ", sent "
+                      << level.bytes << " bytes, imbalance " << level.imbalance << std::endl;
+        }
+    }
+}
+#endif
+
+// Полувнешний BFS: объём чтения по уровням
+void semi_external_test() {
+    std::cout << "\nSEMI-EXTERNAL BFS TEST" << std::endl;
+
+    auto graph = create_cube_grid(200, 200, 200);
+    std::string path = (std::filesystem::temp_directory_path() / "parbfs_semiext_bench.bin").string();
+    write_graph_file(path, graph);
+    std::cout << "Graph written: " << graph.size() << " vertices, "
+              << std::filesystem::file_size(path) / (1 << 20) << " MiB" << std::endl;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto in_memory = parallel_bfs(graph, 0);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto memory_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    graph.clear();
+    graph.shrink_to_fit();
+
+    for (size_t block_bytes : {size_t(1) << 20, size_t(16) << 20}) {
+        semi_external_stats stats;
         start_time = std::chrono::high_resolution_clock::now();
-        auto seq_result = sequential_bfs(graph, start);
+        auto ext = semi_external_bfs(path, 0, &stats, block_bytes);
         end_time = std::chrono::high_resolution_clock::now();
+        auto ext_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        std::cout << "\nBlock " << (block_bytes >> 20) << " MiB: " << ext_ms << " ms ("
+                  << (ext == in_memory ? "matches" : "DIFFERS FROM") << " in-memory BFS, " << memory_ms << " ms), "
+                  << stats.blocks << " blocks, " << stats.total_bytes_read / (1 << 20) << " MiB read" << std::endl;
+        for (size_t l = 0; l < stats.levels.size(); l += 100) {
+            const auto& level = stats.levels[l];
+            std::cout << "  Level " << l << ": " << level.bytes_read / 1024 << " KiB read, "
+                      << level.blocks_read << " blocks read, " << level.blocks_skipped << " skipped" << std::endl;
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+// Влияние huge pages: граф в CSR и буферы обхода в арене, с 2 МБ страницами и без
+void huge_pages_test() {
+    std::cout << "\nHUGE PAGES TEST" << std::endl;
+
+    auto cube = create_cube_grid(300, 300, 300);
+    perf_counter dtlb(perf_counter::event::dtlb_load_misses);
+    if (!dtlb.available()) {
+        std::cout << "dTLB counter unavailable, reporting time only" << std::endl;
+    }
+
+    long long times[2] = {0, 0};
+    uint64_t misses[2] = {0, 0};
+    for (bool huge : {false, true}) {
+        arena::set_huge_pages(huge);
+        csr_graph graph(cube);
+
+        std::cout << "\nHuge pages " << (huge ? "on" : "off") << " (5 runs)" << std::endl;
+        for (int run = 0; run < 5; run++) {
+            dtlb.start();
+            auto start_time = std::chrono::high_resolution_clock::now();
+            auto result = parallel_bfs(graph, 0);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            dtlb.stop();
+
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+            times[huge] += duration.count();
+            record(huge ? "huge_pages_bfs_ms" : "regular_pages_bfs_ms", duration.count());
+            misses[huge] += dtlb.read();
+            std::cout << "  Run " << (run + 1) << ": " << duration.count() << " ms";
+            if (dtlb.available()) std::cout << ", " << dtlb.read() << " dTLB load misses";
+            std::cout << std::endl;
+        }
+    }
+    arena::set_huge_pages(true);
+
+    arena::usage usage = arena::total_usage();
+    std::cout << "\nArena: " << (usage.explicit_bytes >> 20) << " MiB explicit huge pages, "
+              << (usage.transparent_bytes >> 20) << " MiB transparent, "
+              << (usage.fallback_bytes >> 20) << " MiB regular" << std::endl;
+    std::cout << "Average time: " << times[0] / 5 << " ms -> " << times[1] / 5 << " ms ("
+              << (times[0] - times[1]) / 5 << " ms saved)" << std::endl;
+    if (dtlb.available() && misses[0] > 0) {
+        std::cout << "dTLB load misses: " << misses[0] / 5 << " -> " << misses[1] / 5 << " ("
+                  << std::fixed << std::setprecision(1)
+                  << 100.0 * (1.0 - static_cast<double>(misses[1]) / misses[0]) << "% fewer)" << std::endl;
+    }
+}
 
+// Пропускная способность build_graph на случайных рёбрах, до max_edges рёбер
+void graph_build_test(size_t max_edges) {
+    std::cout << "\nGRAPH BUILD TEST" << std::endl;
+
+    for (size_t m = size_t(1) << 24; m <= max_edges; m *= 4) {
+        size_t n = m / 8;
+        std::vector<std::pair<int, int>> edges(m);
+        std::pair<int, int>* data = edges.data();
+        parlay::parallel_for(0, m,
+            [=] (size_t i) {
+                data[i] = {static_cast<int>(parlay::hash64(2 * i) % n),
+                           static_cast<int>(parlay::hash64(2 * i + 1) % n)};
+            }
+        );
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        csr_graph graph = build_graph(n, edges);
+        auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        seq_times.push_back(duration.count());
+        record("build_" + std::to_string(m >> 20) + "M_edges_ms", duration.count());
 
-        std::cout << "  Run " << (run + 1) << ": " << duration.count() << " ms" << std::endl;
+        std::cout << m / 1000000 << "M edges -> " << graph.num_edges() / 1000000 << "M arcs on "
+                  << n / 1000000 << "M vertices: " << duration.count() << " ms, "
+                  << std::fixed << std::setprecision(1)
+                  << m / 1e3 / std::max<double>(duration.count(), 1) << "M edges/s" << std::endl;
     }
+}
 
-    long long avg_seq = std::accumulate(seq_times.begin(), seq_times.end(), 0LL) / seq_times.size();
-    std::cout << "Average sequential time: " << avg_seq << " ms" << std::endl;
+// Битовый BFS по решётке против parallel_bfs по тому же кубу в CSR
+void grid_test() {
+    std::cout << "\nGRID BFS TEST (" << grid_bfs_kernel() << ")" << std::endl;
 
-    std::cout << "\nTesting Parallel BFS (5 runs)" << std::endl;
-    std::vector<long long> par_times;
+    csr_graph graph(create_cube_grid(300, 300, 300));
+    std::vector<int> expected;
+    long long csr_ms = 0;
+    long long grid_ms = 0;
+
+    for (int run = 0; run < 5; run++) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        auto result = parallel_bfs(graph, 0);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        csr_ms += ms;
+        record("grid_parallel_bfs_ms", ms);
+        if (run == 0) expected = std::move(result);
+    }
 
+    bool matches = true;
     for (int run = 0; run < 5; run++) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        auto result = grid_bfs(300, 300, 300, 0);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        grid_ms += duration.count();
+        record("grid_bfs_ms", duration.count());
+        matches = matches && result == expected;
+        std::cout << "  Run " << (run + 1) << ": " << duration.count() << " ms" << std::endl;
+    }
+
+    std::cout << "\nParallel BFS (CSR): " << csr_ms / 5 << " ms" << std::endl;
+    std::cout << "Grid BFS:           " << grid_ms / 5 << " ms (" << (matches ? "matches" : "DIFFERS") << ")" << std::endl;
+    std::cout << "Speedup: " << std::fixed << std::setprecision(2)
+              << static_cast<double>(csr_ms) / std::max<long long>(grid_ms, 1) << "x" << std::endl;
+}
+
+// BFS с переключением направления по каждому доступному ядру против parallel_bfs
+void direction_optimizing_test() {
+    std::cout << "\nDIRECTION-OPTIMIZING BFS TEST" << std::endl;
+
+    size_t n = size_t(1) << 22;
+    size_t m = size_t(1) << 25;
+    std::vector<std::pair<int, int>> edges(m);
+    std::pair<int, int>* data = edges.data();
+    parlay::parallel_for(0, m,
+        [=] (size_t i) {
+            data[i] = {static_cast<int>(parlay::hash64(2 * i) % n),
+                       static_cast<int>(parlay::hash64(2 * i + 1) % n)};
+        }
+    );
+    csr_graph random_graph = build_graph(n, edges);
+    edges.clear();
+    edges.shrink_to_fit();
+    csr_graph cube(create_cube_grid(200, 200, 200));
+
+    std::vector<simd_level> kernels = {simd_level::scalar};
+    if (best_simd_level() >= simd_level::avx2) kernels.push_back(simd_level::avx2);
+    if (best_simd_level() >= simd_level::avx512) kernels.push_back(simd_level::avx512);
+
+    for (const auto& [name, graph] : {std::pair<const char*, const csr_graph*>{"random", &random_graph},
+                                      std::pair<const char*, const csr_graph*>{"cube 200^3", &cube}}) {
+        std::cout << "\n" << name << ": " << graph->size() << " vertices, " << graph->num_edges() << " arcs" << std::endl;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        auto expected = parallel_bfs(*graph, 0);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << "  parallel_bfs: " << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count()
+                  << " ms" << std::endl;
+
+        for (simd_level kernel : kernels) {
+            long long total_ms = 0;
+            bool matches = true;
+            for (int run = 0; run < 3; run++) {
+                start_time = std::chrono::high_resolution_clock::now();
+                auto result = direction_optimizing_bfs(*graph, 0, kernel);
+                end_time = std::chrono::high_resolution_clock::now();
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+                total_ms += ms;
+                record(std::string("dobfs_") + name + "_" + simd_level_name(kernel) + "_ms", ms);
+                matches = matches && result == expected;
+            }
+            std::cout << "  direction-optimizing, " << simd_level_name(kernel) << ": " << total_ms / 3 << " ms"
+                      << (matches ? "" : " (DIFFERS)") << std::endl;
+        }
+    }
+}
+
+// Асинхронный BFS против parallel_bfs на графах большого диаметра
+void async_test() {
+    std::cout << "\nASYNC BFS TEST" << std::endl;
+
+    // Дорожная сеть: квадратная решётка без части рёбер и с редкими диагоналями
+    std::mt19937 rng(61);
+    int side = 1000;
+    std::vector<std::pair<int, int>> road_edges;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            int v = x + y * side;
+            if (x + 1 < side && rng() % 10 < 7) road_edges.push_back({v, v + 1});
+            if (y + 1 < side && rng() % 10 < 7) road_edges.push_back({v, v + side});
+            if (x + 1 < side && y + 1 < side && rng() % 20 == 0) road_edges.push_back({v, v + side + 1});
+        }
+    }
+
+    int chain_length = 1000000;
+    std::vector<std::pair<int, int>> chain_edges;
+    for (int v = 0; v + 1 < chain_length; v++) {
+        chain_edges.push_back({v, v + 1});
+    }
+
+    std::vector<std::pair<const char*, csr_graph>> graphs;
+    graphs.emplace_back("cube 100^3", csr_graph(create_cube_grid(100, 100, 100)));
+    graphs.emplace_back("road 1000x1000", build_graph(side * side, road_edges));
+    graphs.emplace_back("chain 10^6", build_graph(chain_length, chain_edges));
+
+    for (const auto& [name, graph] : graphs) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        auto expected = parallel_bfs(graph, 0);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto sync_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        int levels = *std::max_element(expected.begin(), expected.end()) + 1;
+
+        async_stats stats;
         start_time = std::chrono::high_resolution_clock::now();
-        auto par_result = parallel_bfs(graph, start);
+        auto result = async_bfs(graph, 0, &stats);
         end_time = std::chrono::high_resolution_clock::now();
+        auto async_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        record(std::string("async_") + name + "_parallel_bfs_ms", sync_ms);
+        record(std::string("async_") + name + "_async_bfs_ms", async_ms);
+
+        std::cout << "\n" << name << ": " << graph.size() << " vertices, " << levels << " levels" << std::endl;
+        std::cout << "  parallel_bfs: " << sync_ms << " ms" << std::endl;
+        std::cout << "  async_bfs:    " << async_ms << " ms (" << (result == expected ? "matches" : "DIFFERS") << "), "
+                  << stats.relaxations << " relaxations, " << stats.shared_chunks << " chunks shared" << std::endl;
+    }
+}
 
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        par_times.push_back(duration.count());
+// Фронт в чанках потоков против общего сжатия через scan в parallel_bfs
+void local_frontier_test() {
+    std::cout << "\nLOCAL FRONTIER BFS TEST" << std::endl;
+
+    size_t n = size_t(1) << 22;
+    size_t m = size_t(1) << 24;
+    std::vector<std::pair<int, int>> edges(m);
+    std::pair<int, int>* data = edges.data();
+    parlay::parallel_for(0, m,
+        [=] (size_t i) {
+            data[i] = {static_cast<int>(parlay::hash64(2 * i) % n),
+                       static_cast<int>(parlay::hash64(2 * i + 1) % n)};
+        }
+    );
+
+    std::vector<std::pair<const char*, csr_graph>> graphs;
+    graphs.emplace_back("cube 200^3", csr_graph(create_cube_grid(200, 200, 200)));
+    graphs.emplace_back("random", build_graph(n, edges));
+
+    for (const auto& [name, graph] : graphs) {
+        long long sync_ms = 0;
+        long long local_ms = 0;
+        bool matches = true;
+        for (int run = 0; run < 3; run++) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            auto expected = parallel_bfs(graph, 0);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            sync_ms += ms;
+            record(std::string("local_") + name + "_parallel_bfs_ms", ms);
+
+            start_time = std::chrono::high_resolution_clock::now();
+            auto result = local_frontier_bfs(graph, 0);
+            end_time = std::chrono::high_resolution_clock::now();
+            ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            local_ms += ms;
+            record(std::string("local_") + name + "_local_frontier_bfs_ms", ms);
+            matches = matches && result == expected;
+        }
 
-        std::cout << "  Run " << (run + 1) << ": " << duration.count() << " ms" << std::endl;
+        std::cout << "\n" << name << ": " << graph.size() << " vertices" << std::endl;
+        std::cout << "  parallel_bfs:       " << sync_ms / 3 << " ms" << std::endl;
+        std::cout << "  local_frontier_bfs: " << local_ms / 3 << " ms (" << (matches ? "matches" : "DIFFERS") << ")" << std::endl;
     }
+}
 
-    long long avg_par = std::accumulate(par_times.begin(), par_times.end(), 0LL) / par_times.size();
-    std::cout << "Average parallel time: " << avg_par << " ms" << std::endl;
+// Цена детерминированного выбора родителей
+void deterministic_test() {
+    std::cout << "\nDETERMINISTIC BFS TREE TEST" << std::endl;
+
+    size_t n = size_t(1) << 22;
+    size_t m = size_t(1) << 24;
+    std::vector<std::pair<int, int>> edges(m);
+    std::pair<int, int>* data = edges.data();
+    parlay::parallel_for(0, m,
+        [=] (size_t i) {
+            data[i] = {static_cast<int>(parlay::hash64(2 * i) % n),
+                       static_cast<int>(parlay::hash64(2 * i + 1) % n)};
+        }
+    );
+
+    std::vector<std::pair<const char*, csr_graph>> graphs;
+    graphs.emplace_back("cube 200^3", csr_graph(create_cube_grid(200, 200, 200)));
+    graphs.emplace_back("random", build_graph(n, edges));
+
+    for (const auto& [name, graph] : graphs) {
+        long long times[3] = {0, 0, 0};
+        bool stable = true;
+        bfs_tree first;
+        for (int run = 0; run < 3; run++) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            parallel_bfs(graph, 0);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto ms0 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            times[0] += ms0;
+            record(std::string("deterministic_") + name + "_parallel_bfs_ms", ms0);
+
+            start_time = std::chrono::high_resolution_clock::now();
+            parallel_bfs_tree(graph, 0, false);
+            end_time = std::chrono::high_resolution_clock::now();
+            auto ms1 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            times[1] += ms1;
+            record(std::string("deterministic_") + name + "_tree_first_claim_ms", ms1);
+
+            start_time = std::chrono::high_resolution_clock::now();
+            bfs_tree tree = parallel_bfs_tree(graph, 0, true);
+            end_time = std::chrono::high_resolution_clock::now();
+            auto ms2 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            times[2] += ms2;
+            record(std::string("deterministic_") + name + "_tree_deterministic_ms", ms2);
+
+            if (run == 0) {
+                first = std::move(tree);
+            } else {
+                stable = stable && tree.parent == first.parent && tree.order == first.order;
+            }
+        }
 
-    std::cout << "\nPERFORMANCE RESULTS" << std::endl;
-    std::cout << "Sequential BFS: " << avg_seq << " ms" << std::endl;
-    std::cout << "Parallel BFS:   " << avg_par << " ms" << std::endl;
+        std::cout << "\n" << name << ": " << graph.size() << " vertices" << std::endl;
+        std::cout << "  parallel_bfs (distances only): " << times[0] / 3 << " ms" << std::endl;
+        std::cout << "  tree, first claim wins:        " << times[1] / 3 << " ms" << std::endl;
+        std::cout << "  tree, deterministic:           " << times[2] / 3 << " ms ("
+                  << std::fixed << std::setprecision(2) << static_cast<double>(times[2]) / std::max<long long>(times[1], 1)
+                  << "x, " << (stable ? "identical across runs" : "DIFFERS ACROSS RUNS") << ")" << std::endl;
+    }
+}
 
+// Цена проверок прерывания и задержка от отмены до возврата
+void cancellation_test() {
+    std::cout << "\nCANCELLATION TEST" << std::endl;
 
-    double speedup = static_cast<double>(avg_seq) / avg_par;
-    std::cout << "Speedup: " << std::fixed << std::setprecision(2) << speedup << "x" << std::endl;
+    csr_graph graph(create_cube_grid(200, 200, 200));
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    parallel_bfs(graph, 0);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto plain_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    std::cout << "parallel_bfs: " << plain_ms << " ms" << std::endl;
+
+    for (size_t every : {size_t(0), size_t(4096)}) {
+        std::atomic<bool> cancel(false);
+        bfs_options options;
+        options.cancel = &cancel;
+        options.check_every_edges = every;
+
+        start_time = std::chrono::high_resolution_clock::now();
+        bfs_result full = parallel_bfs(graph, 0, options);
+        end_time = std::chrono::high_resolution_clock::now();
+        auto full_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        // Отмена на середине обхода
+        std::chrono::high_resolution_clock::time_point cancelled_at;
+        std::thread canceller([&cancel, &cancelled_at, full_ms] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(full_ms / 2));
+            cancelled_at = std::chrono::high_resolution_clock::now();
+            cancel.store(true);
+        });
+        bfs_result partial = parallel_bfs(graph, 0, options);
+        end_time = std::chrono::high_resolution_clock::now();
+        canceller.join();
+        auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(end_time - cancelled_at).count();
+
+        std::cout << "\nChecks " << (every == 0 ? "at level boundaries" : "every 4096 edges") << ":" << std::endl;
+        std::cout << "  full traversal: " << full_ms << " ms" << (full.complete() ? "" : " (INCOMPLETE)") << std::endl;
+        std::cout << "  cancelled at level " << partial.level << ", " << latency_us << " us after the request" << std::endl;
+    }
+}
+
+// Обход с упавшими вершинами: фильтр внутри обхода против копии подграфа
+void filter_test() {
+    std::cout << "\nFILTERED BFS TEST" << std::endl;
+
+    auto cube = create_cube_grid(200, 200, 200);
+    csr_graph graph(cube);
+    size_t n = graph.size();
+
+    vertex_mask mask(n);
+    for (size_t v = 1; v < n; v++) {
+        if (parlay::hash64(v) % 10 == 0) mask.exclude(v);
+    }
+
+    long long times[4] = {0, 0, 0, 0};
+    bool matches = true;
+    for (int run = 0; run < 3; run++) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        auto plain = parallel_bfs(graph, 0);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto ms0 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        times[0] += ms0;
+        record("filter_parallel_bfs_ms", ms0);
+
+        start_time = std::chrono::high_resolution_clock::now();
+        auto unfiltered = filtered_bfs(graph, 0);
+        end_time = std::chrono::high_resolution_clock::now();
+        auto ms1 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        times[1] += ms1;
+        record("filter_unfiltered_ms", ms1);
+
+        start_time = std::chrono::high_resolution_clock::now();
+        auto filtered = filtered_bfs(graph, 0, mask);
+        end_time = std::chrono::high_resolution_clock::now();
+        auto ms2 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        times[2] += ms2;
+        record("filter_mask_ms", ms2);
+
+        // Копия подграфа без упавших вершин и обход по ней
+        start_time = std::chrono::high_resolution_clock::now();
+        csr_graph sub(copy_subgraph(cube, mask, all_edges()));
+        auto copied = parallel_bfs(sub, 0);
+        end_time = std::chrono::high_resolution_clock::now();
+        auto ms3 = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+        times[3] += ms3;
+        record("filter_copy_subgraph_ms", ms3);
+
+        matches = matches && unfiltered == plain && filtered == copied;
+    }
 
+    std::cout << "\nCube 200^3, 10% of vertices down" << std::endl;
+    std::cout << "  parallel_bfs:               " << times[0] / 3 << " ms" << std::endl;
+    std::cout << "  filtered_bfs, no filter:    " << times[1] / 3 << " ms" << std::endl;
+    std::cout << "  filtered_bfs, vertex mask:  " << times[2] / 3 << " ms" << std::endl;
+    std::cout << "  copy subgraph + BFS:        " << times[3] / 3 << " ms ("
+              << (matches ? "matches" : "DIFFERS") << ")" << std::endl;
 }
 
-int main() {
+
+// Перекошенный поток запросов: немногие источники дают большую часть вызовов
+void cache_test() {
+    std::cout << "\nBFS CACHE TEST" << std::endl;
+
+    size_t n = size_t(1) << 20;
+    size_t m = size_t(1) << 22;
+    std::vector<std::pair<int, int>> edges(m);
+    std::pair<int, int>* data = edges.data();
+    parlay::parallel_for(0, m,
+        [=] (size_t i) {
+            data[i] = {static_cast<int>(parlay::hash64(2 * i) % n),
+                       static_cast<int>(parlay::hash64(2 * i + 1) % n)};
+        }
+    );
+    csr_graph graph = build_graph(n, edges);
+
+    // 90% запросов - из 20 горячих источников
+    const int queries = 200;
+    std::mt19937 rng(47);
+    std::vector<int> sources(queries);
+    for (int& s : sources) {
+        s = rng() % 10 < 9 ? parlay::hash64(rng() % 20) % n : rng() % n;
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (int s : sources) {
+        parallel_bfs(graph, s);
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto plain_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    record("cache_uncached_ms", plain_ms);
+
+    bfs_cache cache(size_t(256) << 20);
+    uint64_t version = new_graph_version();
+    bool matches = true;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int s : sources) {
+        matches = matches && cached_bfs(cache, graph, version, s).size() == n;
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    auto cached_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    record("cache_cached_ms", cached_ms);
+    bfs_cache_stats stats = cache.stats();
+
+    // Один запрос: вычисление против копии из кэша
+    std::vector<int> hit;
+    start_time = std::chrono::high_resolution_clock::now();
+    auto computed = parallel_bfs(graph, sources[0]);
+    end_time = std::chrono::high_resolution_clock::now();
+    auto compute_us = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+    start_time = std::chrono::high_resolution_clock::now();
+    cache.lookup(bfs_cache_key{version, sources[0], 0}, hit);
+    end_time = std::chrono::high_resolution_clock::now();
+    auto hit_us = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+    record("cache_hit_us", hit_us);
+    matches = matches && hit == computed;
+
+    std::cout << "\nRandom graph: " << n << " vertices, " << queries << " queries" << std::endl;
+    std::cout << "  without cache: " << plain_ms << " ms" << std::endl;
+    std::cout << "  with cache:    " << cached_ms << " ms (" << stats.hits << " hits, " << stats.misses << " misses, "
+              << stats.entries << " entries in " << stats.bytes / (1 << 20) << " MB)" << std::endl;
+    std::cout << "  one query: " << compute_us << " us computed, " << hit_us << " us from cache ("
+              << (matches ? "matches" : "DIFFERS") << ")" << std::endl;
+}
+
+// Индекс меток на графе со степенным распределением степеней и на кубе
+void landmarks_test() {
+    std::cout << "\nLANDMARK INDEX TEST" << std::endl;
+
+    // Оба конца ребра с перекосом к малым номерам: немногие вершины-хабы
+    // собирают большую часть рёбер, как в социальных графах
+    size_t n = size_t(1) << 16;
+    size_t m = size_t(1) << 19;
+    std::vector<std::pair<int, int>> edges(m);
+    std::pair<int, int>* data = edges.data();
+    parlay::parallel_for(0, m,
+        [=] (size_t i) {
+            double x = static_cast<double>(parlay::hash64(2 * i) % (1 << 30)) / (1 << 30);
+            double y = static_cast<double>(parlay::hash64(2 * i + 1) % (1 << 30)) / (1 << 30);
+            data[i] = {static_cast<int>(static_cast<double>(n) * x * x * x),
+                       static_cast<int>(static_cast<double>(n) * y * y)};
+        }
+    );
+
+    // Куб 300^3 и случайный граф на 4M вершин не годятся: на решётках и
+    // равномерных графах меток на вершину почти n (см. Readme)
+    std::vector<std::pair<const char*, csr_graph>> graphs;
+    graphs.emplace_back("skewed", build_graph(n, edges));
+    graphs.emplace_back("cube 20^3", csr_graph(create_cube_grid(20, 20, 20)));
+
+    std::string path = (std::filesystem::temp_directory_path() / "parbfs_landmarks_bench.bin").string();
+    for (const auto& [name, graph] : graphs) {
+        landmark_build_stats stats;
+        landmark_index index(graph, 0, &stats);
+        record(std::string("landmarks_") + name + "_build_ms", stats.seconds * 1000);
+        record(std::string("landmarks_") + name + "_bytes", static_cast<double>(index.bytes()));
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        write_landmark_index(path, index);
+        landmark_index loaded = read_landmark_index(path);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto io_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        // Задержка запроса на случайных парах
+        const size_t queries = 1000000;
+        size_t vertices = graph.size();
+        long long checksum = 0;
+        start_time = std::chrono::high_resolution_clock::now();
+        for (size_t q = 0; q < queries; q++) {
+            checksum += loaded.distance(parlay::hash64(2 * q) % vertices, parlay::hash64(2 * q + 1) % vertices);
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        double query_ns = std::chrono::duration<double, std::nano>(end_time - start_time).count() / queries;
+        record(std::string("landmarks_") + name + "_query_ns", query_ns);
+
+        // Проверка по обходам из нескольких источников
+        bool matches = true;
+        for (size_t s = 0; s < 3; s++) {
+            int source = parlay::hash64(s + 17) % vertices;
+            auto expected = parallel_bfs(graph, source);
+            for (size_t q = 0; q < 1000; q++) {
+                int t = parlay::hash64(q + 1000 * s) % vertices;
+                matches = matches && loaded.distance(source, t) == expected[t];
+            }
+        }
+
+        start_time = std::chrono::high_resolution_clock::now();
+        parallel_bfs(graph, 0);
+        end_time = std::chrono::high_resolution_clock::now();
+        auto bfs_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        std::cout << "\n" << name << ": " << vertices << " vertices, " << graph.num_edges() << " arcs" << std::endl;
+        std::cout << "  build: " << std::fixed << std::setprecision(2) << stats.seconds << " s in " << stats.batches
+                  << " batches, " << static_cast<double>(stats.labels) / vertices << " labels per vertex, "
+                  << index.bytes() / (1 << 20) << " MB" << std::endl;
+        std::cout << "  save + load: " << io_ms << " ms" << std::endl;
+        std::cout << "  query: " << query_ns << " ns (checksum " << checksum << ", "
+                  << (matches ? "matches BFS" : "DIFFERS FROM BFS") << "), one parallel_bfs: " << bfs_ms << " ms" << std::endl;
+    }
+    std::filesystem::remove(path);
+}
+
+// Аппаратные счётчики по фазам и уровням parallel_bfs на кубе
+void profile_test() {
+    std::cout << "\nBFS PROFILE TEST" << std::endl;
+
+    csr_graph graph(create_cube_grid(200, 200, 200));
+    // Потоки планировщика должны существовать до открытия счётчиков
+    parallel_bfs(graph, 0);
+
+    bfs_profile profile;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    profiled_bfs(graph, 0, profile);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    const char* names[] = {"dTLB load misses", "cycles", "instructions", "LLC misses", "branch misses"};
+    std::cout << "\nCube 200^3: " << profile.levels.size() << " levels, " << ms << " ms with probes, "
+              << parlay::num_workers() << " workers" << std::endl;
+    if (!profile.counters_available()) {
+        std::cout << "Hardware counters unavailable (perf_event_open), reporting time only" << std::endl;
+    } else {
+        std::cout << "Counters:";
+        for (size_t i = 0; i < profile.events.size(); i++) {
+            if (profile.available[i]) std::cout << " " << names[static_cast<int>(profile.events[i])] << ";";
+        }
+        std::cout << std::endl;
+    }
+
+    auto print_sample = [&profile, &names] (const char* phase, const phase_sample& sample) {
+        std::cout << "  " << std::left << std::setw(8) << phase << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << sample.seconds * 1000 << " ms";
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        for (size_t i = 0; i < profile.events.size() && i < sample.values.size(); i++) {
+            if (!profile.available[i]) continue;
+            if (profile.events[i] == perf_counter::event::cycles) cycles = sample.values[i];
+            if (profile.events[i] == perf_counter::event::instructions) instructions = sample.values[i];
+            std::cout << ", " << sample.values[i] << " " << names[static_cast<int>(profile.events[i])];
+        }
+        if (cycles > 0) std::cout << ", IPC " << std::setprecision(2) << static_cast<double>(instructions) / cycles;
+        std::cout << std::endl;
+    };
+
+    std::cout << "\nBy phase:" << std::endl;
+    phase_sample expand = profile.total(&level_profile::expand);
+    phase_sample scan = profile.total(&level_profile::scan);
+    phase_sample scatter = profile.total(&level_profile::scatter);
+    print_sample("init", profile.init);
+    print_sample("expand", expand);
+    print_sample("scan", scan);
+    print_sample("scatter", scatter);
+    record("profile_init_ms", profile.init.seconds * 1000);
+    record("profile_expand_ms", expand.seconds * 1000);
+    record("profile_scan_ms", scan.seconds * 1000);
+    record("profile_scatter_ms", scatter.seconds * 1000);
+
+    // Уровни с шагом и самый широкий
+    size_t widest = 0;
+    for (size_t l = 0; l < profile.levels.size(); l++) {
+        if (profile.levels[l].frontier_size > profile.levels[widest].frontier_size) widest = l;
+    }
+    std::cout << "\nBy level:" << std::endl;
+    for (size_t l = 0; l < profile.levels.size(); l++) {
+        if (l % 100 != 0 && l != widest) continue;
+        const level_profile& level = profile.levels[l];
+        std::cout << "Level " << l << (l == widest ? " (widest)" : "") << ": frontier " << level.frontier_size << std::endl;
+        print_sample("expand", level.expand);
+        print_sample("scan", level.scan);
+        print_sample("scatter", level.scatter);
+    }
+}
+
+// Подбор параметров на выборке графа и сохранение профиля хоста
+void tune_test(const std::string& graph_path) {
+    std::cout << "\nAUTOTUNE" << std::endl;
+
+    csr_graph graph = graph_path.empty() ? csr_graph(create_cube_grid(200, 200, 200))
+                                         : csr_graph(read_graph_file(graph_path));
+    std::cout << "Graph: " << (graph_path.empty() ? "cube 200^3" : graph_path) << ", " << graph.size() << " vertices" << std::endl;
+
+    autotune_result result = autotune(graph);
+    const bfs_tuning& t = result.tuning;
+    std::cout << "\nSample of " << result.sample_vertices << " vertices: " << std::fixed << std::setprecision(1)
+              << result.default_ms << " ms with defaults -> " << result.tuned_ms << " ms tuned" << std::endl;
+    std::cout << "  expand_grain " << t.expand_grain << ", scan_grain " << t.scan_grain << ", scatter_grain "
+              << t.scatter_grain << ", sequential_below " << t.sequential_below << std::endl;
+    std::cout << "  dobfs_alpha " << t.dobfs_alpha << ", dobfs_beta " << t.dobfs_beta << std::endl;
+    record("tune_sample_default_ms", result.default_ms);
+    record("tune_sample_tuned_ms", result.tuned_ms);
+
+    // Весь граф с параметрами по умолчанию и подобранными
+    long long times[2] = {0, 0};
+    for (int tuned = 0; tuned < 2; tuned++) {
+        scoped_tuning scope(tuned ? t : bfs_tuning());
+        for (int run = 0; run < 3; run++) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            parallel_bfs(graph, 0);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            times[tuned] += ms;
+            record(tuned ? "tune_full_tuned_ms" : "tune_full_default_ms", ms);
+        }
+    }
+    std::cout << "\nFull graph: " << times[0] / 3 << " ms with defaults -> " << times[1] / 3 << " ms tuned" << std::endl;
+
+    std::string path = default_tuning_path();
+    save_tuning(path, t);
+    std::cout << "Profile saved to " << path << std::endl;
+}
+
+// speed_measure <режим> [--record file.jsonl] (список режимов в Readme): после тестов корректности
+// запускает выбранный замер производительности, по умолчанию тест на большом кубе. С --record
+// замеры дописываются строкой в файл JSON lines.
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args;
+    std::string record_path;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    std::string mode = args.empty() ? "all" : args[0];
+
+    if (mode == "compare") {
+        try {
+            return compare_command(args);
+        } catch (const std::exception& e) {
+            std::cout << "Compare failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "PARALLEL BFS TEST SUITE" << std::endl;
 
+    try {
+        if (load_default_tuning()) std::cout << "Tuning profile: " << default_tuning_path() << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Ignoring tuning profile: " << e.what() << std::endl;
+    }
+
     bool all_tests_passed = true;
 
     // Запуск всех тестов на корректность
@@ -550,6 +3382,128 @@ int main() {
         std::cout << "\nSmall cube test failed!" << std::endl;
     }
 
+    if (!test_connected_components()) {
+        all_tests_passed = false;
+        std::cout << "\nConnected components tests failed!" << std::endl;
+    }
+
+    if (!test_dynamic_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nDynamic BFS tests failed!" << std::endl;
+    }
+
+    if (!test_query_batch()) {
+        all_tests_passed = false;
+        std::cout << "\nQuery batch tests failed!" << std::endl;
+    }
+
+    if (!test_delta_stepping()) {
+        all_tests_passed = false;
+        std::cout << "\nDelta-stepping tests failed!" << std::endl;
+    }
+
+    if (!test_khop()) {
+        all_tests_passed = false;
+        std::cout << "\nK-hop tests failed!" << std::endl;
+    }
+
+    if (!test_betweenness()) {
+        all_tests_passed = false;
+        std::cout << "\nBetweenness tests failed!" << std::endl;
+    }
+
+    if (!test_diameter()) {
+        all_tests_passed = false;
+        std::cout << "\nDiameter tests failed!" << std::endl;
+    }
+
+    if (!test_harmonic_centrality()) {
+        all_tests_passed = false;
+        std::cout << "\nHarmonic centrality tests failed!" << std::endl;
+    }
+
+    if (!test_semi_external_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nSemi-external BFS tests failed!" << std::endl;
+    }
+
+    if (!test_huge_page_arena()) {
+        all_tests_passed = false;
+        std::cout << "\nHuge page arena tests failed!" << std::endl;
+    }
+
+    if (!test_graph_builder()) {
+        all_tests_passed = false;
+        std::cout << "\nGraph builder tests failed!" << std::endl;
+    }
+
+    if (!test_grid_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nGrid BFS tests failed!" << std::endl;
+    }
+
+    if (!test_direction_optimizing_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nDirection-optimizing BFS tests failed!" << std::endl;
+    }
+
+    if (!test_async_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nAsync BFS tests failed!" << std::endl;
+    }
+
+    if (!test_local_frontier_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nLocal frontier BFS tests failed!" << std::endl;
+    }
+
+    if (!test_bfs_tree()) {
+        all_tests_passed = false;
+        std::cout << "\nBFS tree tests failed!" << std::endl;
+    }
+
+    if (!test_bfs_options()) {
+        all_tests_passed = false;
+        std::cout << "\nBFS options tests failed!" << std::endl;
+    }
+
+    if (!test_filtered_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nFiltered BFS tests failed!" << std::endl;
+    }
+
+    if (!test_bfs_cache()) {
+        all_tests_passed = false;
+        std::cout << "\nBFS cache tests failed!" << std::endl;
+    }
+
+    if (!test_landmark_index()) {
+        all_tests_passed = false;
+        std::cout << "\nLandmark index tests failed!" << std::endl;
+    }
+
+    if (!test_bfs_profile()) {
+        all_tests_passed = false;
+        std::cout << "\nBFS profile tests failed!" << std::endl;
+    }
+
+    if (!test_tuning()) {
+        all_tests_passed = false;
+        std::cout << "\nTuning tests failed!" << std::endl;
+    }
+
+    if (!test_bench_record()) {
+        all_tests_passed = false;
+        std::cout << "\nBench record tests failed!" << std::endl;
+    }
+
+#ifndef _WIN32
+    if (!test_partitioned_bfs()) {
+        all_tests_passed = false;
+        std::cout << "\nPartitioned BFS tests failed!" << std::endl;
+    }
+#endif
+
     if (!all_tests_passed) {
         std::cout << "\nCORRECTNESS TESTS FAILED! Aborting performance test." << std::endl;
         return 1;
@@ -557,7 +3511,57 @@ int main() {
 
     std::cout << "\nALL CORRECTNESS TESTS PASSED!" << std::endl;
 
-    performance_test();
+    bench_run run = bench_run::current();
+    run.mode = mode;
+    if (!record_path.empty()) recorded_run = &run;
+
+    if (mode == "all") {
+        performance_test();
+    } else if (mode == "queries") {
+        query_throughput_test();
+    } else if (mode == "centrality") {
+        centrality_throughput_test();
+    } else if (mode == "external") {
+        semi_external_test();
+    } else if (mode == "hugepages") {
+        huge_pages_test();
+    } else if (mode == "grid") {
+        grid_test();
+    } else if (mode == "dobfs") {
+        direction_optimizing_test();
+    } else if (mode == "async") {
+        async_test();
+    } else if (mode == "local") {
+        local_frontier_test();
+    } else if (mode == "deterministic") {
+        deterministic_test();
+    } else if (mode == "cancel") {
+        cancellation_test();
+    } else if (mode == "filter") {
+        filter_test();
+    } else if (mode == "cache") {
+        cache_test();
+    } else if (mode == "landmarks") {
+        landmarks_test();
+    } else if (mode == "profile") {
+        profile_test();
+    } else if (mode == "tune") {
+        tune_test(args.size() > 1 ? args[1] : "");
+    } else if (mode == "build") {
+        graph_build_test(args.size() > 1 ? std::stoull(args[1]) : size_t(1) << 30);
+#ifndef _WIN32
+    } else if (mode == "partitioned") {
+        partitioned_test();
+#endif
+    } else if (mode != "tests") {
+        std::cout << "\nUnknown mode: " << mode << std::endl;
+        return 1;
+    }
+
+    if (recorded_run) {
+        append_bench_run(record_path, run);
+        std::cout << "\nResults appended to " << record_path << std::endl;
+    }
 
     std::cout << "\nTEST SUITE COMPLETE" << std::endl;
 
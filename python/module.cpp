@@ -0,0 +1,288 @@
+// Модуль Python parallel_bfs: CSR-граф передаётся массивами через протокол
+// буфера без копирования, результаты отдаются массивами IntArray поверх памяти
+// движка (numpy.asarray(a) - view без копирования). На время обхода GIL
+// отпускается.
+//
+//   distance = parallel_bfs.bfs(indptr, indices, start)
+//   distance, parent = parallel_bfs.bfs_tree(indptr, indices, start, deterministic=True)
+//
+// indptr - n + 1 целых по 8 байт, indices - целые по 4 байта (как CSR в
+// scipy.sparse с int64/int32), оба C-contiguous.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "bfs_tree.h"
+#include "csr_graph.h"
+#include "parbfs.h"
+#include "tuning.h"
+#include <parlay/parallel.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// IntArray: владеет std::vector<int> с результатом обхода
+struct int_array {
+    PyObject_HEAD
+    std::vector<int>* values;
+    Py_ssize_t shape;
+    Py_ssize_t stride;
+};
+
+PyTypeObject* int_array_type = nullptr;
+
+void int_array_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    delete reinterpret_cast<int_array*>(self)->values;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+int int_array_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    int_array* a = reinterpret_cast<int_array*>(self);
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = a->values->data();
+    view->len = a->shape * static_cast<Py_ssize_t>(sizeof(int));
+    view->readonly = 0;
+    view->itemsize = sizeof(int);
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("i") : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &a->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &a->stride : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+Py_ssize_t int_array_length(PyObject* self) {
+    return reinterpret_cast<int_array*>(self)->shape;
+}
+
+PyType_Slot int_array_slots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(int_array_dealloc)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(int_array_getbuffer)},
+    {Py_sq_length, reinterpret_cast<void*>(int_array_length)},
+    {Py_tp_doc, const_cast<char*>("int32 array owned by the BFS engine, exposed through the buffer protocol")},
+    {0, nullptr}
+};
+
+PyType_Spec int_array_spec = {
+    "parallel_bfs.IntArray",
+    sizeof(int_array),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    int_array_slots
+};
+
+PyObject* wrap(std::vector<int>&& values) {
+    int_array* a = PyObject_New(int_array, int_array_type);
+    if (a == nullptr) return nullptr;
+    a->values = new (std::nothrow) std::vector<int>(std::move(values));
+    if (a->values == nullptr) {
+        Py_DECREF(a);
+        return PyErr_NoMemory();
+    }
+    a->shape = static_cast<Py_ssize_t>(a->values->size());
+    a->stride = sizeof(int);
+    return reinterpret_cast<PyObject*>(a);
+}
+
+// Буфер, освобождаемый при выходе из области видимости
+class buffer_guard {
+public:
+    ~buffer_guard() {
+        if (acquired_) PyBuffer_Release(&view_);
+    }
+
+    // false с выставленным исключением Python, если буфер не подходит
+    bool acquire(PyObject* obj, const char* name, Py_ssize_t itemsize) {
+        if (PyObject_GetBuffer(obj, &view_, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) return false;
+        acquired_ = true;
+
+        const char* format = view_.format ? view_.format : "B";
+        char code = format[std::strlen(format) - 1];
+        if (view_.ndim > 1 || view_.itemsize != itemsize || std::strchr("bBhHiIlLqQnN", code) == nullptr) {
+            PyErr_Format(PyExc_TypeError, "%s must be a 1-D array of %zd-byte integers, got format '%s' with itemsize %zd",
+                         name, itemsize, format, view_.itemsize);
+            return false;
+        }
+        return true;
+    }
+
+    const void* data() const { return view_.buf; }
+    size_t size() const { return static_cast<size_t>(view_.len / view_.itemsize); }
+
+private:
+    Py_buffer view_;
+    bool acquired_ = false;
+};
+
+// Проверка CSR до обхода: движок не проверяет индексы
+bool check_csr(const uint64_t* offsets, const int* targets, size_t n, size_t m) {
+    if (offsets[0] != 0 || offsets[n] != m) return false;
+    std::atomic<bool> ok(true);
+    parlay::parallel_for(0, n,
+        [&] (size_t v) {
+            if (offsets[v] > offsets[v + 1]) ok.store(false, std::memory_order_relaxed);
+        }
+    );
+    if (!ok.load()) return false;
+    parlay::parallel_for(0, m,
+        [&] (size_t i) {
+            if (targets[i] < 0 || static_cast<size_t>(targets[i]) >= n) ok.store(false, std::memory_order_relaxed);
+        }
+    );
+    return ok.load();
+}
+
+// Общий разбор аргументов: граф, старт и отпущенный GIL вокруг run(view).
+// run возвращает объект результата уже после возврата GIL.
+template <typename Run, typename Build>
+PyObject* traverse(PyObject* indptr, PyObject* indices, int start, int validate, Run run, Build build) {
+    buffer_guard offsets_buf;
+    buffer_guard targets_buf;
+    if (!offsets_buf.acquire(indptr, "indptr", 8) || !targets_buf.acquire(indices, "indices", 4)) return nullptr;
+
+    if (offsets_buf.size() == 0) {
+        PyErr_SetString(PyExc_ValueError, "indptr must have n + 1 elements");
+        return nullptr;
+    }
+    size_t n = offsets_buf.size() - 1;
+    size_t m = targets_buf.size();
+    if (start < 0 || static_cast<size_t>(start) >= n) {
+        PyErr_Format(PyExc_IndexError, "start %d is out of range for %zu vertices", start, n);
+        return nullptr;
+    }
+
+    const uint64_t* offsets = static_cast<const uint64_t*>(offsets_buf.data());
+    const int* targets = static_cast<const int*>(targets_buf.data());
+    csr_view graph(offsets, targets, n);
+
+    bool valid = true;
+    std::string error;
+    bool out_of_memory = false;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        valid = !validate || check_csr(offsets, targets, n, m);
+        if (valid) run(graph);
+    } catch (const std::bad_alloc&) {
+        out_of_memory = true;
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    Py_END_ALLOW_THREADS
+
+    if (out_of_memory) return PyErr_NoMemory();
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, error.c_str());
+        return nullptr;
+    }
+    if (!valid) {
+        PyErr_SetString(PyExc_ValueError,
+                        "invalid CSR: indptr must start at 0, be non-decreasing and end at len(indices), "
+                        "indices must be in [0, n)");
+        return nullptr;
+    }
+    return build();
+}
+
+PyObject* py_bfs(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"indptr", "indices", "start", "validate", nullptr};
+    PyObject* indptr;
+    PyObject* indices;
+    int start;
+    int validate = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOi|p", const_cast<char**>(keywords),
+                                     &indptr, &indices, &start, &validate)) {
+        return nullptr;
+    }
+
+    std::vector<int> distance;
+    return traverse(indptr, indices, start, validate,
+        [&] (const csr_view& graph) { distance = parallel_bfs(graph, start); },
+        [&] { return wrap(std::move(distance)); }
+    );
+}
+
+PyObject* py_bfs_tree(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"indptr", "indices", "start", "deterministic", "validate", nullptr};
+    PyObject* indptr;
+    PyObject* indices;
+    int start;
+    int deterministic = 1;
+    int validate = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOi|pp", const_cast<char**>(keywords),
+                                     &indptr, &indices, &start, &deterministic, &validate)) {
+        return nullptr;
+    }
+
+    bfs_tree tree;
+    return traverse(indptr, indices, start, validate,
+        [&] (const csr_view& graph) { tree = parallel_bfs_tree(graph, start, deterministic != 0); },
+        [&] () -> PyObject* {
+            PyObject* distance = wrap(std::move(tree.distance));
+            if (distance == nullptr) return nullptr;
+            PyObject* parent = wrap(std::move(tree.parent));
+            if (parent == nullptr) {
+                Py_DECREF(distance);
+                return nullptr;
+            }
+            PyObject* result = PyTuple_Pack(2, distance, parent);
+            Py_DECREF(distance);
+            Py_DECREF(parent);
+            return result;
+        }
+    );
+}
+
+PyMethodDef methods[] = {
+    {"bfs", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(py_bfs)), METH_VARARGS | METH_KEYWORDS,
+     "bfs(indptr, indices, start, validate=True) -> IntArray of distances (-1 for unreachable)"},
+    {"bfs_tree", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(py_bfs_tree)), METH_VARARGS | METH_KEYWORDS,
+     "bfs_tree(indptr, indices, start, deterministic=True, validate=True) -> (distance, parent) IntArrays"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT,
+    "parallel_bfs",
+    "Parallel BFS engines over zero-copy CSR buffers",
+    -1,
+    methods,
+    nullptr, nullptr, nullptr, nullptr
+};
+
+}
+
+PyMODINIT_FUNC PyInit_parallel_bfs() {
+    int_array_type = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&int_array_spec));
+    if (int_array_type == nullptr) return nullptr;
+
+    PyObject* module = PyModule_Create(&module_def);
+    if (module == nullptr) return nullptr;
+
+    // Профиль хоста от speed_measure tune; испорченный профиль не мешает импорту
+    try {
+        load_default_tuning();
+    } catch (const std::exception& e) {
+        if (PyErr_WarnEx(PyExc_RuntimeWarning, e.what(), 1) != 0) {
+            Py_DECREF(module);
+            return nullptr;
+        }
+    }
+
+    Py_INCREF(int_array_type);
+    if (PyModule_AddObject(module, "IntArray", reinterpret_cast<PyObject*>(int_array_type)) != 0) {
+        Py_DECREF(int_array_type);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,51 @@
+"""Проверка модуля parallel_bfs без numpy: python smoke_test.py <каталог модуля>."""
+import sys
+from array import array
+
+sys.path.insert(0, sys.argv[1] if len(sys.argv) > 1 else ".")
+import parallel_bfs
+
+
+def csr(adjacency):
+    indptr = array("q", [0])
+    indices = array("i")
+    for neighbours in adjacency:
+        indices.extend(neighbours)
+        indptr.append(len(indices))
+    return indptr, indices
+
+
+def expect_error(error, call):
+    try:
+        call()
+    except error:
+        return
+    raise AssertionError("expected " + error.__name__)
+
+
+# Цепочка 0-1-2-3 и изолированная вершина 4
+indptr, indices = csr([[1], [0, 2], [1, 3], [2], []])
+
+assert memoryview(parallel_bfs.bfs(indptr, indices, 0)).tolist() == [0, 1, 2, 3, -1]
+assert memoryview(parallel_bfs.bfs(indptr, indices, 2, validate=False)).tolist() == [2, 1, 0, 1, -1]
+
+for deterministic in (True, False):
+    distance, parent = parallel_bfs.bfs_tree(indptr, indices, 0, deterministic=deterministic)
+    assert memoryview(distance).tolist() == [0, 1, 2, 3, -1]
+    assert memoryview(parent).tolist() == [-1, 0, 1, 2, -1]
+
+# Ширина и тип элементов буферов
+expect_error(TypeError, lambda: parallel_bfs.bfs(array("i", indptr), indices, 0))
+expect_error(TypeError, lambda: parallel_bfs.bfs(array("d", indptr), indices, 0))
+expect_error(TypeError, lambda: parallel_bfs.bfs(indptr, array("q", indices), 0))
+expect_error(TypeError, lambda: parallel_bfs.bfs([0, 1], indices, 0))
+
+# Проверка CSR и старта
+expect_error(ValueError, lambda: parallel_bfs.bfs(array("q"), indices, 0))
+expect_error(ValueError, lambda: parallel_bfs.bfs(indptr, array("i", [1, 0, 2, 1, 3]), 0))
+expect_error(ValueError, lambda: parallel_bfs.bfs(indptr, array("i", [1, 0, 2, 1, 3, 9]), 0))
+expect_error(ValueError, lambda: parallel_bfs.bfs_tree(array("q", [0, 2, 1, 5, 6, 6]), indices, 0))
+expect_error(IndexError, lambda: parallel_bfs.bfs(indptr, indices, 5))
+expect_error(IndexError, lambda: parallel_bfs.bfs_tree(indptr, indices, -1))
+
+print("parallel_bfs smoke test passed")
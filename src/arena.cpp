@@ -0,0 +1,115 @@
+#include "arena.h"
+#include <parlay/alloc.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace arena {
+
+namespace {
+enum class kind { explicit_huge, transparent, fallback };
+
+struct mapping {
+    size_t bytes;
+    kind how;
+};
+
+std::atomic<bool> huge_enabled(true);
+std::atomic<size_t> explicit_total(0);
+std::atomic<size_t> transparent_total(0);
+std::atomic<size_t> fallback_total(0);
+
+// Крупных блоков немного, поэтому реестр под мьютексом не мешает
+std::mutex registry_mutex;
+std::unordered_map<void*, mapping>& registry() {
+    static std::unordered_map<void*, mapping> map;
+    return map;
+}
+
+void remember(void* p, size_t bytes, kind how) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry()[p] = {bytes, how};
+}
+
+#ifdef __linux__
+void* map_huge(size_t bytes, kind& how) {
+    size_t rounded = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+    void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+        how = kind::explicit_huge;
+        remember(p, rounded, how);
+        return p;
+    }
+
+    // Пул явных страниц пуст: берём с запасом и выравниваем на 2 МБ, чтобы THP
+    // могли собрать целые страницы
+    size_t padded = rounded + huge_page_size;
+    char* raw = static_cast<char*>(mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED) return nullptr;
+
+    size_t misalign = reinterpret_cast<size_t>(raw) % huge_page_size;
+    size_t head = misalign == 0 ? 0 : huge_page_size - misalign;
+    if (head > 0) munmap(raw, head);
+    if (padded - head > rounded) munmap(raw + head + rounded, padded - head - rounded);
+
+    p = raw + head;
+    madvise(p, rounded, MADV_HUGEPAGE);
+    how = kind::transparent;
+    remember(p, rounded, how);
+    return p;
+}
+#endif
+}
+
+void* allocate(size_t bytes) {
+#ifdef __linux__
+    if (bytes >= large_threshold && huge_enabled.load(std::memory_order_relaxed)) {
+        kind how;
+        if (void* p = map_huge(bytes, how)) {
+            (how == kind::explicit_huge ? explicit_total : transparent_total).fetch_add(bytes);
+            return p;
+        }
+    }
+#endif
+    fallback_total.fetch_add(bytes);
+    return parlay::p_malloc(bytes);
+}
+
+void deallocate(void* p) {
+    if (p == nullptr) return;
+#ifdef __linux__
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto it = registry().find(p);
+        if (it != registry().end()) {
+            munmap(p, it->second.bytes);
+            registry().erase(it);
+            return;
+        }
+    }
+#endif
+    parlay::p_free(p);
+}
+
+void set_huge_pages(bool enabled) {
+    huge_enabled.store(enabled);
+}
+
+bool huge_pages_enabled() {
+    return huge_enabled.load();
+}
+
+usage total_usage() {
+    usage u;
+    u.explicit_bytes = explicit_total.load();
+    u.transparent_bytes = transparent_total.load();
+    u.fallback_bytes = fallback_total.load();
+    return u;
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <parlay/parallel.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Память под графы и рабочие буферы обходов. Блоки от large_threshold
+// выделяются целыми страницами по 2 МБ: сначала явные huge pages
+// (MAP_HUGETLB), затем mmap с madvise(MADV_HUGEPAGE), если ни то ни другое
+// недоступно или huge pages выключены - обычный parlay::p_malloc.
+namespace arena {
+
+constexpr size_t huge_page_size = size_t(2) << 20;
+constexpr size_t large_threshold = size_t(1) << 20;
+
+void* allocate(size_t bytes);
+void deallocate(void* p);
+
+// Переключатель для сравнения: действует на последующие выделения
+void set_huge_pages(bool enabled);
+bool huge_pages_enabled();
+
+struct usage {
+    size_t explicit_bytes = 0;
+    size_t transparent_bytes = 0;
+    size_t fallback_bytes = 0;
+};
+
+// Байты, выделенные каждым из способов за время работы процесса
+usage total_usage();
+
+// Массив из n элементов в памяти арены. Элементы создаются конструктором по
+// умолчанию параллельно: первое касание страниц распределяется по потокам.
+template <typename T>
+class array {
+    static_assert(std::is_trivially_destructible_v<T>, "arena::array holds trivially destructible types");
+
+public:
+    array() = default;
+
+    explicit array(size_t n) : size_(n), data_(static_cast<T*>(allocate(n * sizeof(T)))) {
+        T* data = data_;
+        parlay::parallel_for(0, n,
+            [=] (size_t i) {
+                new (data + i) T();
+            }
+        );
+    }
+
+    array(size_t n, const T& value) : array(n) {
+        T* data = data_;
+        parlay::parallel_for(0, n,
+            [=, &value] (size_t i) {
+                data[i] = value;
+            }
+        );
+    }
+
+    ~array() { deallocate(data_); }
+
+    array(array&& other) noexcept
+        : size_(std::exchange(other.size_, 0)), data_(std::exchange(other.data_, nullptr)) {}
+
+    array& operator=(array&& other) noexcept {
+        std::swap(size_, other.size_);
+        std::swap(data_, other.data_);
+        return *this;
+    }
+
+    array(const array&) = delete;
+    array& operator=(const array&) = delete;
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T* get() const { return data_; }
+    size_t size() const { return size_; }
+
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    size_t size_ = 0;
+    T* data_ = nullptr;
+};
+
+}
@@ -0,0 +1,176 @@
+#include "asyncbfs.h"
+#include "arena.h"
+#include "csr_graph.h"
+#include <parlay/parallel.h>
+#include <atomic>
+#include <climits>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// Очередь длиннее share_threshold отдаёт половину в пул, пока в пуле меньше
+// чанков, чем потоков
+constexpr size_t share_threshold = 256;
+
+using entry = std::pair<int, int>;
+
+bool write_min(std::atomic<int>& a, int value) {
+    int cur = a.load(std::memory_order_relaxed);
+    while (value < cur) {
+        if (a.compare_exchange_weak(cur, value)) return true;
+    }
+    return false;
+}
+
+// Общий пул чанков. Поток считается простаивающим, пока не взял чанк, и
+// снова становится им с пустой очередью; idle меняется только под мьютексом,
+// поэтому если простаивают все и пул пуст, локальной работы ни у кого нет.
+// Ещё не запущенные задачи тоже простаивают и завершению не мешают.
+class shared_pool {
+public:
+    explicit shared_pool(size_t workers) : workers_(workers), idle_count_(workers) {}
+
+    bool hungry() const { return size_.load(std::memory_order_relaxed) < workers_; }
+
+    void give(std::vector<entry>&& chunk) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunks_.push_back(std::move(chunk));
+        size_.store(chunks_.size(), std::memory_order_relaxed);
+    }
+
+    // Вызывается потоком с пустой очередью. true - получен чанк, false - пока
+    // работы нет; done() после этого говорит, закончен ли обход
+    bool take(std::vector<entry>& out, bool& idle) {
+        if (size_.load(std::memory_order_relaxed) == 0 && idle) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!chunks_.empty()) {
+            out = std::move(chunks_.back());
+            chunks_.pop_back();
+            size_.store(chunks_.size(), std::memory_order_relaxed);
+            if (idle) {
+                idle_count_--;
+                idle = false;
+            }
+            return true;
+        }
+        if (!idle) {
+            idle = true;
+            idle_count_++;
+        }
+        if (idle_count_ == workers_) done_.store(true);
+        return false;
+    }
+
+    bool done() const { return done_.load(); }
+
+private:
+    size_t workers_;
+    std::mutex mutex_;
+    std::vector<std::vector<entry>> chunks_;
+    std::atomic<size_t> size_{0};
+    size_t idle_count_;
+    std::atomic<bool> done_{false};
+};
+
+template <typename Graph>
+std::vector<int> async_bfs_impl(const Graph& graph, int start, async_stats* stats) {
+    size_t n = graph.size();
+
+    std::vector<int> res(n, -1);
+    if (n == 0) return res;
+
+    arena::array<std::atomic<int>> dist_holder(n);
+    std::atomic<int>* dist = dist_holder.get();
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            dist[i].store(INT_MAX, std::memory_order_relaxed);
+        }
+    );
+    dist[start].store(0);
+
+    size_t workers = parlay::num_workers();
+    shared_pool pool(workers);
+    pool.give({{start, 0}});
+
+    std::atomic<size_t> relaxations(0);
+    std::atomic<size_t> shared_chunks(0);
+
+    // По задаче на поток, каждая работает до общего завершения
+    parlay::parallel_for(0, workers,
+        [&] (size_t) {
+            std::vector<entry> queue;
+            size_t head = 0;
+            bool idle = true;
+            size_t local_relaxations = 0;
+            size_t local_shared = 0;
+
+            while (true) {
+                if (head == queue.size()) {
+                    queue.clear();
+                    head = 0;
+                    if (!pool.take(queue, idle)) {
+                        if (pool.done()) break;
+                        std::this_thread::yield();
+                        continue;
+                    }
+                }
+
+                auto [v, d] = queue[head++];
+                // Устаревшая запись: вершину уже обработали с меньшим расстоянием
+                if (dist[v].load(std::memory_order_relaxed) < d) continue;
+
+                const auto& adj = graph[v];
+                for (size_t j = 0; j < adj.size(); j++) {
+                    int k = adj[j];
+                    if (write_min(dist[k], d + 1)) {
+                        queue.push_back({k, d + 1});
+                        local_relaxations++;
+                    }
+                }
+
+                if (queue.size() - head > share_threshold && pool.hungry()) {
+                    size_t half = head + (queue.size() - head) / 2;
+                    pool.give(std::vector<entry>(queue.begin() + half, queue.end()));
+                    queue.resize(half);
+                    local_shared++;
+                }
+
+                if (head > share_threshold && head * 2 > queue.size()) {
+                    queue.erase(queue.begin(), queue.begin() + head);
+                    head = 0;
+                }
+            }
+
+            relaxations.fetch_add(local_relaxations);
+            shared_chunks.fetch_add(local_shared);
+        },
+        1
+    );
+
+    int* out = res.data();
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            int d = dist[i].load(std::memory_order_relaxed);
+            out[i] = d == INT_MAX ? -1 : d;
+        }
+    );
+
+    if (stats) {
+        stats->relaxations = relaxations.load();
+        stats->shared_chunks = shared_chunks.load();
+    }
+    return res;
+}
+
+}
+
+std::vector<int> async_bfs(const std::vector<std::vector<int>>& graph, int start, async_stats* stats) {
+    return async_bfs_impl(graph, start, stats);
+}
+
+std::vector<int> async_bfs(const csr_graph& graph, int start, async_stats* stats) {
+    return async_bfs_impl(graph, start, stats);
+}
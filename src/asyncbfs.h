@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class csr_graph;
+
+struct async_stats {
+    // Успешные уменьшения расстояний, больше n - 1 на величину повторной работы
+    size_t relaxations = 0;
+    size_t shared_chunks = 0;
+};
+
+// BFS без барьеров между уровнями: потоки берут вершины из своих очередей и
+// уменьшают расстояния соседей атомарным минимумом, излишек очереди отдают в
+// общий пул. Вершина с уменьшенным расстоянием обрабатывается заново, поэтому
+// результат точный. Завершение - когда все потоки без работы и пул пуст.
+std::vector<int> async_bfs(const std::vector<std::vector<int>>& graph, int start, async_stats* stats = nullptr);
+std::vector<int> async_bfs(const csr_graph& graph, int start, async_stats* stats = nullptr);
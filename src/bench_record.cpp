@@ -0,0 +1,298 @@
+#include "bench_record.h"
+#include "host_info.h"
+#include <parlay/parallel.h>
+#include <cctype>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+// bench_commit.h генерирует CMake при каждой сборке
+#if __has_include("bench_commit.h")
+#include "bench_commit.h"
+#endif
+#ifndef PARALLEL_BFS_COMMIT
+#define PARALLEL_BFS_COMMIT "unknown"
+#endif
+
+namespace {
+
+std::string cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) return line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+    }
+    return "unknown";
+}
+
+std::string compiler_name() {
+#if defined(__clang__)
+    return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string utc_timestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm_utc;
+#ifdef _WIN32
+    gmtime_s(&tm_utc, &now);
+#else
+    gmtime_r(&now, &tm_utc);
+#endif
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+    return buf;
+}
+
+void write_string(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Разбор ровно того подмножества JSON, которое пишет append_bench_run
+class reader {
+public:
+    explicit reader(const std::string& text) : text_(text) {}
+
+    void expect(char c) {
+        skip_spaces();
+        if (pos_ >= text_.size() || text_[pos_] != c) fail(std::string("expected '") + c + "'");
+        pos_++;
+    }
+
+    bool consume(char c) {
+        skip_spaces();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    std::string string() {
+        expect('"');
+        std::string s;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) pos_++;
+            s += text_[pos_++];
+        }
+        expect('"');
+        return s;
+    }
+
+    double number() {
+        skip_spaces();
+        size_t used = 0;
+        double value = 0;
+        try {
+            value = std::stod(text_.substr(pos_, 32), &used);
+        } catch (const std::exception&) {
+            fail("expected a number");
+        }
+        pos_ += used;
+        return value;
+    }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("bench results: " + what + " at offset " + std::to_string(pos_));
+    }
+
+private:
+    void skip_spaces() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+bench_run parse_run(const std::string& line) {
+    bench_run run;
+    reader r(line);
+    r.expect('{');
+    if (r.consume('}')) return run;
+    do {
+        std::string key = r.string();
+        r.expect(':');
+        if (key == "metrics") {
+            r.expect('{');
+            if (!r.consume('}')) {
+                do {
+                    std::pair<std::string, std::vector<double>> metric;
+                    metric.first = r.string();
+                    r.expect(':');
+                    r.expect('[');
+                    if (!r.consume(']')) {
+                        do {
+                            metric.second.push_back(r.number());
+                        } while (r.consume(','));
+                        r.expect(']');
+                    }
+                    run.metrics.push_back(std::move(metric));
+                } while (r.consume(','));
+                r.expect('}');
+            }
+        } else if (key == "threads") {
+            run.threads = static_cast<int>(r.number());
+        } else {
+            std::string value = r.string();
+            if (key == "mode") run.mode = value;
+            else if (key == "timestamp") run.timestamp = value;
+            else if (key == "host") run.host = value;
+            else if (key == "cpu") run.cpu = value;
+            else if (key == "compiler") run.compiler = value;
+            else if (key == "commit") run.commit = value;
+        }
+    } while (r.consume(','));
+    r.expect('}');
+    return run;
+}
+
+// Квантиль 0.975 распределения Стьюдента
+double t_quantile(double df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df < 1) return std::numeric_limits<double>::infinity();
+    if (df > 30) return 1.96;
+    return table[static_cast<int>(std::floor(df)) - 1];
+}
+
+void mean_and_variance(const std::vector<double>& xs, double& mean, double& variance) {
+    mean = 0;
+    for (double x : xs) mean += x;
+    mean /= xs.size();
+    variance = 0;
+    for (double x : xs) variance += (x - mean) * (x - mean);
+    variance = xs.size() > 1 ? variance / (xs.size() - 1) : 0;
+}
+
+}
+
+bench_run bench_run::current() {
+    bench_run run;
+    run.timestamp = utc_timestamp();
+    run.host = host_name();
+    run.cpu = cpu_model();
+    run.threads = static_cast<int>(parlay::num_workers());
+    run.compiler = compiler_name();
+    run.commit = PARALLEL_BFS_COMMIT;
+    return run;
+}
+
+void bench_run::add(const std::string& metric, double value) {
+    for (auto& m : metrics) {
+        if (m.first == metric) {
+            m.second.push_back(value);
+            return;
+        }
+    }
+    metrics.push_back({metric, {value}});
+}
+
+void append_bench_run(const std::string& path, const bench_run& run) {
+    std::ofstream out(path, std::ios::app);
+    if (!out) throw std::runtime_error("cannot open " + path + " for appending");
+
+    std::ostringstream line;
+    line.precision(17);
+    line << "{\"mode\":";
+    write_string(line, run.mode);
+    line << ",\"timestamp\":";
+    write_string(line, run.timestamp);
+    line << ",\"host\":";
+    write_string(line, run.host);
+    line << ",\"cpu\":";
+    write_string(line, run.cpu);
+    line << ",\"threads\":" << run.threads << ",\"compiler\":";
+    write_string(line, run.compiler);
+    line << ",\"commit\":";
+    write_string(line, run.commit);
+    line << ",\"metrics\":{";
+    for (size_t i = 0; i < run.metrics.size(); i++) {
+        if (i > 0) line << ',';
+        write_string(line, run.metrics[i].first);
+        line << ":[";
+        for (size_t j = 0; j < run.metrics[i].second.size(); j++) {
+            if (j > 0) line << ',';
+            line << run.metrics[i].second[j];
+        }
+        line << ']';
+    }
+    line << "}}\n";
+
+    out << line.str();
+    if (!out) throw std::runtime_error("cannot write to " + path);
+}
+
+std::vector<bench_run> read_bench_runs(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open " + path);
+
+    std::vector<bench_run> runs;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        runs.push_back(parse_run(line));
+    }
+    return runs;
+}
+
+std::vector<metric_comparison> compare_bench_runs(const bench_run& before, const bench_run& after) {
+    std::vector<metric_comparison> result;
+    for (const auto& [name, samples_before] : before.metrics) {
+        for (const auto& [other, samples_after] : after.metrics) {
+            if (other != name || samples_before.empty() || samples_after.empty()) continue;
+
+            metric_comparison c;
+            c.metric = name;
+            double var_before, var_after;
+            mean_and_variance(samples_before, c.mean_before, var_before);
+            mean_and_variance(samples_after, c.mean_after, var_after);
+
+            double diff = c.mean_after - c.mean_before;
+            double se_before = var_before / samples_before.size();
+            double se_after = var_after / samples_after.size();
+            double se = std::sqrt(se_before + se_after);
+
+            // Степени свободы Уэлча - Саттертуэйта
+            double df = 0;
+            if (samples_before.size() > 1 && samples_after.size() > 1) {
+                double denom = se_before * se_before / (samples_before.size() - 1) +
+                               se_after * se_after / (samples_after.size() - 1);
+                df = denom > 0 ? (se_before + se_after) * (se_before + se_after) / denom
+                               : std::numeric_limits<double>::infinity();
+            }
+            double half = se > 0 ? t_quantile(df) * se : (df > 0 ? 0 : std::numeric_limits<double>::infinity());
+            c.diff_low = diff - half;
+            c.diff_high = diff + half;
+            c.regression = c.diff_low > 0;
+            c.improvement = c.diff_high < 0;
+            result.push_back(c);
+        }
+    }
+    return result;
+}
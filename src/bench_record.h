@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Один запуск замера: метаданные машины и сборки и замеры по метрикам (по
+// нескольку повторов на метрику). Хранится строкой JSON в файле JSON lines.
+struct bench_run {
+    std::string mode;
+    std::string timestamp;
+    std::string host;
+    std::string cpu;
+    int threads = 0;
+    std::string compiler;
+    std::string commit;
+    std::vector<std::pair<std::string, std::vector<double>>> metrics;
+
+    // Заполняет всё, кроме mode и metrics
+    static bench_run current();
+
+    void add(const std::string& metric, double value);
+};
+
+// Ошибки ввода-вывода и неверный формат - std::runtime_error
+void append_bench_run(const std::string& path, const bench_run& run);
+std::vector<bench_run> read_bench_runs(const std::string& path);
+
+struct metric_comparison {
+    std::string metric;
+    double mean_before = 0;
+    double mean_after = 0;
+    // 95% доверительный интервал разности средних (после - до), Уэлч
+    double diff_low = 0;
+    double diff_high = 0;
+    // Интервал целиком выше нуля: метрика (время) значимо выросла
+    bool regression = false;
+    bool improvement = false;
+};
+
+// Метрики, общие для двух запусков. Меньше двух повторов - интервал
+// бесконечный, значимости нет.
+std::vector<metric_comparison> compare_bench_runs(const bench_run& before, const bench_run& after);
@@ -0,0 +1,141 @@
+#include "betweenness.h"
+#include "arena.h"
+#include "frontier.h"
+#include <atomic>
+#include <random>
+#include <unordered_set>
+
+namespace {
+void atomic_add(std::atomic<double>& a, double value) {
+    double cur = a.load(std::memory_order_relaxed);
+    while (!a.compare_exchange_weak(cur, cur + value)) {
+    }
+}
+
+std::vector<int> sample_sources(size_t n, size_t k, uint64_t seed) {
+    std::vector<int> sources;
+    if (k >= n) {
+        sources.resize(n);
+        for (size_t i = 0; i < n; i++) sources[i] = static_cast<int>(i);
+        return sources;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::unordered_set<int> taken;
+    while (sources.size() < k) {
+        int v = static_cast<int>(rng() % n);
+        if (taken.insert(v).second) sources.push_back(v);
+    }
+    return sources;
+}
+}
+
+std::vector<double> betweenness_centrality(const std::vector<std::vector<int>>& graph,
+                                           size_t num_samples,
+                                           uint64_t seed) {
+    size_t n = graph.size();
+    std::vector<double> bc(n, 0.0);
+    if (n == 0 || num_samples == 0) return bc;
+
+    std::vector<int> sources = sample_sources(n, num_samples, seed);
+
+    // Состояние заводится один раз, после каждого источника сбрасываются
+    // только достигнутые вершины
+    arena::array<std::atomic<int>> dist_holder(n);
+    arena::array<std::atomic<double>> sigma_holder(n);
+    std::atomic<int>* dist = dist_holder.get();
+    std::atomic<double>* sigma = sigma_holder.get();
+    arena::array<double> delta(n, 0.0);
+
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            dist[i].store(-1, std::memory_order_relaxed);
+            sigma[i].store(0, std::memory_order_relaxed);
+        }
+    );
+
+    frontier::buffers buf(n);
+    // Фронты всех уровней подряд, level_start[d] - начало уровня d
+    arena::array<size_t> order(n);
+    std::vector<size_t> level_start;
+
+    for (int s : sources) {
+        dist[s].store(0, std::memory_order_relaxed);
+        sigma[s].store(1, std::memory_order_relaxed);
+        buf.current[0] = static_cast<size_t>(s);
+        buf.current_size = 1;
+
+        level_start.assign(1, 0);
+        size_t reached = 0;
+
+        for (int level = 0; buf.current_size > 0; level++) {
+            size_t* current = buf.current;
+            size_t* dst = order.data() + reached;
+            parlay::parallel_for(0, buf.current_size,
+                [=] (size_t i) {
+                    dst[i] = current[i];
+                }
+            );
+            reached += buf.current_size;
+            level_start.push_back(reached);
+
+            // Кратчайшие пути к вершине следующего уровня приходят от всех
+            // её соседей на текущем уровне, sigma которых уже окончательны
+            frontier::expand(graph, buf,
+                [dist, sigma, level] (size_t from, size_t k) {
+                    int cur = dist[k].load(std::memory_order_relaxed);
+                    bool claimed = false;
+                    if (cur == -1) {
+                        claimed = dist[k].compare_exchange_strong(cur, level + 1);
+                        if (claimed) cur = level + 1;
+                    }
+                    if (cur == level + 1) {
+                        atomic_add(sigma[k], sigma[from].load(std::memory_order_relaxed));
+                    }
+                    return claimed;
+                }
+            );
+        }
+
+        // Обратный проход по уровням: зависимости собираются с уровня ниже без атомиков
+        size_t levels = level_start.size() - 1;
+        for (size_t l = levels; l-- > 0;) {
+            size_t lo = level_start[l];
+            size_t hi = level_start[l + 1];
+            int next_level = static_cast<int>(l) + 1;
+
+            parlay::parallel_for(lo, hi,
+                [&graph, &order, &delta, &bc, dist, sigma, next_level, s] (size_t i) {
+                    size_t v = order[i];
+                    double sv = sigma[v].load(std::memory_order_relaxed);
+                    double acc = 0;
+                    for (int w : graph[v]) {
+                        if (dist[w].load(std::memory_order_relaxed) == next_level) {
+                            acc += sv / sigma[w].load(std::memory_order_relaxed) * (1.0 + delta[w]);
+                        }
+                    }
+                    delta[v] = acc;
+                    if (static_cast<int>(v) != s) bc[v] += acc;
+                }
+            );
+        }
+
+        parlay::parallel_for(0, reached,
+            [&order, &delta, dist, sigma] (size_t i) {
+                size_t v = order[i];
+                dist[v].store(-1, std::memory_order_relaxed);
+                sigma[v].store(0, std::memory_order_relaxed);
+                delta[v] = 0;
+            }
+        );
+    }
+
+    double scale = 0.5 * static_cast<double>(n) / static_cast<double>(sources.size());
+    parlay::parallel_for(0, n,
+        [&bc, scale] (size_t i) {
+            bc[i] *= scale;
+        }
+    );
+
+    return bc;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Центральность по посредничеству (Brandes) для неориентированного графа,
+// каждая неупорядоченная пара вершин учитывается один раз. При
+// num_samples < n источники выбираются случайно без повторов и сумма
+// масштабируется на n / num_samples; иначе ответ точный.
+std::vector<double> betweenness_centrality(const std::vector<std::vector<int>>& graph,
+                                           size_t num_samples,
+                                           uint64_t seed = 1);
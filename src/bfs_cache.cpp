@@ -0,0 +1,191 @@
+#include "bfs_cache.h"
+#include "csr_graph.h"
+#include "parbfs.h"
+#include <parlay/parallel.h>
+#include <parlay/utilities.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr size_t block_size = 1 << 16;
+
+template <typename T>
+void pack_as(const int* distance, size_t n, uint8_t* out) {
+    T* packed = reinterpret_cast<T*>(out);
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            packed[i] = static_cast<T>(distance[i]);
+        }
+    );
+}
+
+template <typename T>
+void unpack_as(const uint8_t* in, size_t n, int* distance) {
+    const T* packed = reinterpret_cast<const T*>(in);
+    constexpr T unreachable = static_cast<T>(-1);
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            T d = packed[i];
+            distance[i] = d == unreachable ? -1 : static_cast<int>(d);
+        }
+    );
+}
+
+template <typename Graph>
+std::vector<int> cached_bfs_impl(bfs_cache& cache, const Graph& graph, uint64_t graph_version, int source) {
+    bfs_cache_key key{graph_version, source, 0};
+    std::vector<int> distance;
+    if (cache.lookup(key, distance)) return distance;
+
+    distance = parallel_bfs(graph, source);
+    cache.insert(key, distance);
+    return distance;
+}
+
+}
+
+packed_levels packed_levels::pack(const std::vector<int>& distance) {
+    size_t n = distance.size();
+    const int* dist = distance.data();
+
+    // Глубина обхода: максимум по блокам
+    size_t blocks = (n + block_size - 1) / block_size;
+    std::vector<int> block_max(blocks, -1);
+    int* maxima = block_max.data();
+    parlay::parallel_for(0, blocks,
+        [=] (size_t b) {
+            size_t end = std::min(n, (b + 1) * block_size);
+            int m = -1;
+            for (size_t i = b * block_size; i < end; i++) {
+                m = std::max(m, dist[i]);
+            }
+            maxima[b] = m;
+        }
+    );
+    int depth = block_max.empty() ? -1 : *std::max_element(block_max.begin(), block_max.end());
+
+    packed_levels res;
+    res.size = n;
+    res.width = depth < 0xff ? 1 : depth < 0xffff ? 2 : 4;
+    res.data.resize(n * res.width);
+
+    if (res.width == 1) {
+        pack_as<uint8_t>(dist, n, res.data.data());
+    } else if (res.width == 2) {
+        pack_as<uint16_t>(dist, n, res.data.data());
+    } else {
+        std::memcpy(res.data.data(), dist, n * sizeof(int));
+    }
+    return res;
+}
+
+void packed_levels::unpack(std::vector<int>& distance) const {
+    distance.resize(size);
+    if (width == 1) {
+        unpack_as<uint8_t>(data.data(), size, distance.data());
+    } else if (width == 2) {
+        unpack_as<uint16_t>(data.data(), size, distance.data());
+    } else {
+        std::memcpy(distance.data(), data.data(), size * sizeof(int));
+    }
+}
+
+size_t bfs_cache::key_hash::operator()(const bfs_cache_key& key) const {
+    uint64_t h = parlay::hash64(key.graph_version);
+    h = parlay::hash64(h ^ static_cast<uint32_t>(key.source));
+    return parlay::hash64(h ^ key.variant);
+}
+
+bfs_cache::bfs_cache(size_t budget_bytes) : budget_(budget_bytes) {}
+
+bool bfs_cache::lookup(const bfs_cache_key& key, std::vector<int>& distance) {
+    std::shared_ptr<const packed_levels> levels;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            stats_.misses++;
+            return false;
+        }
+        stats_.hits++;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        levels = it->second->levels;
+    }
+    // Вытесненная запись живёт, пока её распаковывают
+    levels->unpack(distance);
+    return true;
+}
+
+void bfs_cache::insert(const bfs_cache_key& key, const std::vector<int>& distance) {
+    auto levels = std::make_shared<const packed_levels>(packed_levels::pack(distance));
+    size_t bytes = levels->bytes();
+    if (bytes > budget_) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Результат, посчитанный до invalidate
+    if (stale_.count(key.graph_version)) return;
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        stats_.bytes -= it->second->levels->bytes();
+        it->second->levels = std::move(levels);
+        stats_.bytes += bytes;
+        lru_.splice(lru_.begin(), lru_, it->second);
+    } else {
+        evict_to(budget_ - bytes);
+        lru_.push_front(entry{key, std::move(levels)});
+        index_.emplace(key, lru_.begin());
+        stats_.bytes += bytes;
+        stats_.entries++;
+    }
+    evict_to(budget_);
+}
+
+void bfs_cache::evict_to(size_t bytes) {
+    while (stats_.bytes > bytes && !lru_.empty()) {
+        entry& last = lru_.back();
+        stats_.bytes -= last.levels->bytes();
+        stats_.entries--;
+        stats_.evictions++;
+        index_.erase(last.key);
+        lru_.pop_back();
+    }
+}
+
+void bfs_cache::invalidate(uint64_t stale_version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stale_.insert(stale_version);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->key.graph_version == stale_version) {
+            stats_.bytes -= it->levels->bytes();
+            stats_.entries--;
+            index_.erase(it->key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void bfs_cache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+}
+
+bfs_cache_stats bfs_cache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::vector<int> cached_bfs(bfs_cache& cache, const std::vector<std::vector<int>>& graph,
+                            uint64_t graph_version, int source) {
+    return cached_bfs_impl(cache, graph, graph_version, source);
+}
+
+std::vector<int> cached_bfs(bfs_cache& cache, const csr_graph& graph, uint64_t graph_version, int source) {
+    return cached_bfs_impl(cache, graph, graph_version, source);
+}
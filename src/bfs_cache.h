@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class csr_graph;
+
+// Ключ результата. graph_version - версия из new_graph_version() (или
+// dynamic_bfs::graph_version()): она уникальна в процессе, поэтому один кэш
+// можно делить между графами. variant различает обходы с разными результатами
+// на одном графе (фильтры, ограничения); у parallel_bfs он 0.
+struct bfs_cache_key {
+    uint64_t graph_version = 0;
+    int source = 0;
+    uint64_t variant = 0;
+
+    bool operator==(const bfs_cache_key& other) const {
+        return graph_version == other.graph_version && source == other.source && variant == other.variant;
+    }
+};
+
+struct bfs_cache_stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// Расстояния, упакованные по 1, 2 или 4 байта на вершину в зависимости от
+// глубины обхода; недостижимые - максимальное значение ширины
+struct packed_levels {
+    size_t size = 0;
+    unsigned width = 1;
+    std::vector<uint8_t> data;
+
+    static packed_levels pack(const std::vector<int>& distance);
+    void unpack(std::vector<int>& distance) const;
+    size_t bytes() const { return sizeof(packed_levels) + data.size(); }
+};
+
+// Кэш результатов BFS с вытеснением давно не запрошенных (LRU) в пределах
+// budget_bytes. Потокобезопасен; упаковка и распаковка идут вне блокировки.
+// Результаты версий, переданных в invalidate, не выдаются и не сохраняются.
+class bfs_cache {
+public:
+    explicit bfs_cache(size_t budget_bytes);
+
+    bool lookup(const bfs_cache_key& key, std::vector<int>& distance);
+    void insert(const bfs_cache_key& key, const std::vector<int>& distance);
+
+    // Версия графа устарела: удаляет её результаты, не трогая другие графы
+    void invalidate(uint64_t stale_version);
+    void clear();
+
+    bfs_cache_stats stats() const;
+    size_t budget() const { return budget_; }
+
+private:
+    struct key_hash {
+        size_t operator()(const bfs_cache_key& key) const;
+    };
+
+    struct entry {
+        bfs_cache_key key;
+        std::shared_ptr<const packed_levels> levels;
+    };
+
+    void evict_to(size_t bytes);
+
+    size_t budget_;
+
+    mutable std::mutex mutex_;
+    // Спереди - последние запрошенные
+    std::list<entry> lru_;
+    std::unordered_map<bfs_cache_key, std::list<entry>::iterator, key_hash> index_;
+    // Устаревшие версии: результат, досчитанный после invalidate, отбрасывается
+    std::unordered_set<uint64_t> stale_;
+    bfs_cache_stats stats_;
+};
+
+// parallel_bfs с кэшем: при попадании результат копируется из кэша
+std::vector<int> cached_bfs(bfs_cache& cache, const std::vector<std::vector<int>>& graph,
+                            uint64_t graph_version, int source);
+std::vector<int> cached_bfs(bfs_cache& cache, const csr_graph& graph, uint64_t graph_version, int source);
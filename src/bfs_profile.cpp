@@ -0,0 +1,163 @@
+#include "bfs_profile.h"
+#include "csr_graph.h"
+#include "frontier.h"
+#include <chrono>
+#include <utility>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Снимает время и счётчики на границах фаз и относит разность к фазе,
+// которая только что закончилась
+class phase_recorder {
+public:
+    phase_recorder(perf_counter_set& counters, bfs_profile& profile)
+        : counters_(counters), profile_(profile), previous_(counters.size()), now_(counters.size()) {}
+
+    void begin() {
+        counters_.start();
+        current_ = &profile_.init;
+        snapshot(previous_);
+        previous_time_ = clock_type::now();
+    }
+
+    void operator()(frontier::phase p) {
+        auto time = clock_type::now();
+        snapshot(now_);
+        if (current_) {
+            current_->seconds += std::chrono::duration<double>(time - previous_time_).count();
+            current_->values.resize(now_.size(), 0);
+            for (size_t i = 0; i < now_.size(); i++) {
+                current_->values[i] += now_[i] - previous_[i];
+            }
+        }
+
+        switch (p) {
+        case frontier::phase::init:
+            current_ = &profile_.init;
+            break;
+        case frontier::phase::expand:
+            profile_.levels.emplace_back();
+            profile_.levels.back().frontier_size = frontier_size;
+            current_ = &profile_.levels.back().expand;
+            break;
+        case frontier::phase::scan:
+            current_ = &profile_.levels.back().scan;
+            break;
+        case frontier::phase::scatter:
+            current_ = &profile_.levels.back().scatter;
+            break;
+        case frontier::phase::done:
+            current_ = nullptr;
+            break;
+        }
+
+        // Время чтения счётчиков не попадает в фазы
+        std::swap(previous_, now_);
+        previous_time_ = clock_type::now();
+    }
+
+    void end() { counters_.stop(); }
+
+    size_t frontier_size = 0;
+
+private:
+    void snapshot(std::vector<uint64_t>& values) {
+        if (counters_.any_available()) counters_.read(values.data());
+    }
+
+    perf_counter_set& counters_;
+    bfs_profile& profile_;
+    phase_sample* current_ = nullptr;
+    std::vector<uint64_t> previous_;
+    std::vector<uint64_t> now_;
+    clock_type::time_point previous_time_;
+};
+
+template <typename Graph>
+std::vector<int> profiled_impl(const Graph& edges, int start_int, bfs_profile& profile,
+                               const std::vector<perf_counter::event>& events) {
+    perf_counter_set counters(events);
+    profile = bfs_profile();
+    profile.events = events;
+    for (size_t i = 0; i < events.size(); i++) {
+        profile.available.push_back(counters.available(i));
+    }
+
+    phase_recorder recorder(counters, profile);
+    recorder.begin();
+
+    size_t n = edges.size();
+    std::vector<int> res(n, -1);
+    if (n == 0) {
+        recorder(frontier::phase::done);
+        recorder.end();
+        return res;
+    }
+
+    int* dist = res.data();
+    size_t start = static_cast<size_t>(start_int);
+
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
+
+    visited.claim(start);
+    dist[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+
+    while (buf.current_size > 0) {
+        recorder.frontier_size = buf.current_size;
+        frontier::expand(edges, buf,
+            [&visited, dist] (size_t from, size_t k) {
+                if (visited.claim(k)) {
+                    dist[k] = dist[from] + 1;
+                    return true;
+                }
+                return false;
+            },
+            recorder
+        );
+    }
+
+    recorder.end();
+    return res;
+}
+
+}
+
+bool bfs_profile::counters_available() const {
+    for (char a : available) {
+        if (a) return true;
+    }
+    return false;
+}
+
+phase_sample bfs_profile::total(phase_sample level_profile::*phase) const {
+    phase_sample sum;
+    sum.values.assign(events.size(), 0);
+    for (const level_profile& level : levels) {
+        const phase_sample& sample = level.*phase;
+        sum.seconds += sample.seconds;
+        for (size_t i = 0; i < sample.values.size(); i++) {
+            sum.values[i] += sample.values[i];
+        }
+    }
+    return sum;
+}
+
+std::vector<perf_counter::event> default_profile_events() {
+    return {perf_counter::event::cycles, perf_counter::event::instructions, perf_counter::event::cache_misses,
+            perf_counter::event::dtlb_load_misses, perf_counter::event::branch_misses};
+}
+
+std::vector<int> profiled_bfs(const std::vector<std::vector<int>>& graph, int start, bfs_profile& profile,
+                              const std::vector<perf_counter::event>& events) {
+    return profiled_impl(graph, start, profile, events);
+}
+
+std::vector<int> profiled_bfs(const csr_graph& graph, int start, bfs_profile& profile,
+                              const std::vector<perf_counter::event>& events) {
+    return profiled_impl(graph, start, profile, events);
+}
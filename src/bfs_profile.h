@@ -0,0 +1,47 @@
+#pragma once
+
+#include "perf_counters.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class csr_graph;
+
+// Замер одной фазы: время и значения событий bfs_profile::events
+struct phase_sample {
+    double seconds = 0;
+    std::vector<uint64_t> values;
+};
+
+struct level_profile {
+    size_t frontier_size = 0;
+    // Обход рёбер фронта, префиксные суммы, сборка следующего фронта
+    phase_sample expand;
+    phase_sample scan;
+    phase_sample scatter;
+};
+
+// Профиль parallel_bfs по фазам и уровням. Счётчики суммируются по всем
+// потокам процесса; если perf_event_open недоступен, остаётся только время.
+struct bfs_profile {
+    std::vector<perf_counter::event> events;
+    std::vector<char> available;
+
+    // Заполнение массивов и буферов
+    phase_sample init;
+    std::vector<level_profile> levels;
+
+    bool counters_available() const;
+    // Сумма фазы по всем уровням
+    phase_sample total(phase_sample level_profile::*phase) const;
+};
+
+// Те же события, что в profiled_bfs по умолчанию
+std::vector<perf_counter::event> default_profile_events();
+
+// parallel_bfs с замером фаз. Потоки планировщика должны уже существовать
+// (счётчики открываются на потоки процесса в момент вызова).
+std::vector<int> profiled_bfs(const std::vector<std::vector<int>>& graph, int start, bfs_profile& profile,
+                              const std::vector<perf_counter::event>& events = default_profile_events());
+std::vector<int> profiled_bfs(const csr_graph& graph, int start, bfs_profile& profile,
+                              const std::vector<perf_counter::event>& events = default_profile_events());
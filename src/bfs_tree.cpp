@@ -0,0 +1,118 @@
+#include "bfs_tree.h"
+#include "arena.h"
+#include "csr_graph.h"
+#include "frontier.h"
+#include <parlay/parallel.h>
+#include <atomic>
+#include <climits>
+
+namespace {
+
+bool write_min(std::atomic<int>& a, int value) {
+    int cur = a.load(std::memory_order_relaxed);
+    while (value < cur) {
+        if (a.compare_exchange_weak(cur, value)) return true;
+    }
+    return false;
+}
+
+template <typename Graph>
+bfs_tree bfs_tree_impl(const Graph& graph, int start_int, bool deterministic) {
+    size_t n = graph.size();
+
+    bfs_tree tree;
+    tree.distance.assign(n, -1);
+    tree.parent.assign(n, -1);
+    if (n == 0) return tree;
+
+    tree.order.resize(n);
+    int* dist = tree.distance.data();
+    int* parent = tree.parent.data();
+    int* order = tree.order.data();
+    size_t start = static_cast<size_t>(start_int);
+
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
+
+    arena::array<std::atomic<int>> candidate_holder;
+    if (deterministic) {
+        candidate_holder = arena::array<std::atomic<int>>(n);
+        std::atomic<int>* candidate = candidate_holder.get();
+        parlay::parallel_for(0, n,
+            [=] (size_t i) {
+                candidate[i].store(INT_MAX, std::memory_order_relaxed);
+            }
+        );
+    }
+    std::atomic<int>* candidate = candidate_holder.get();
+
+    visited.claim(start);
+    dist[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+    size_t reached = 0;
+
+    while (buf.current_size > 0) {
+        size_t* current = buf.current;
+        parlay::parallel_for(0, buf.current_size,
+            [=] (size_t i) {
+                order[reached + i] = static_cast<int>(current[i]);
+            }
+        );
+        reached += buf.current_size;
+
+        if (!deterministic) {
+            frontier::expand(graph, buf,
+                [&visited, dist, parent] (size_t from, size_t k) {
+                    if (visited.claim(k)) {
+                        dist[k] = dist[from] + 1;
+                        parent[k] = static_cast<int>(from);
+                        return true;
+                    }
+                    return false;
+                }
+            );
+            continue;
+        }
+
+        // Фаза 1: минимальный номер родителя. dist в ней только читается
+        parlay::parallel_for(0, buf.current_size,
+            [&graph, candidate, current, dist] (size_t i) {
+                int u = static_cast<int>(current[i]);
+                const auto& adj = graph[u];
+                for (size_t j = 0; j < adj.size(); j++) {
+                    int k = adj[j];
+                    if (dist[k] < 0) write_min(candidate[k], u);
+                }
+            }
+        );
+
+        // Фаза 2: вершину берёт только её кандидат, claim отсекает кратные рёбра
+        frontier::expand(graph, buf,
+            [&visited, candidate, dist, parent] (size_t from, size_t k) {
+                if (candidate[k].load(std::memory_order_relaxed) != static_cast<int>(from)) return false;
+                if (!visited.claim(k)) return false;
+                dist[k] = dist[from] + 1;
+                parent[k] = static_cast<int>(from);
+                return true;
+            }
+        );
+    }
+
+    tree.order.resize(reached);
+    return tree;
+}
+
+}
+
+bfs_tree parallel_bfs_tree(const std::vector<std::vector<int>>& graph, int start, bool deterministic) {
+    return bfs_tree_impl(graph, start, deterministic);
+}
+
+bfs_tree parallel_bfs_tree(const csr_graph& graph, int start, bool deterministic) {
+    return bfs_tree_impl(graph, start, deterministic);
+}
+
+bfs_tree parallel_bfs_tree(const csr_view& graph, int start, bool deterministic) {
+    return bfs_tree_impl(graph, start, deterministic);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+class csr_graph;
+class csr_view;
+
+struct bfs_tree {
+    std::vector<int> distance;
+    // -1 у корня и недостижимых вершин
+    std::vector<int> parent;
+    // Достижимые вершины по уровням, внутри уровня - в порядке фронта
+    std::vector<int> order;
+};
+
+// BFS с деревом обхода. В детерминированном режиме уровень идёт в две фазы:
+// сначала каждая непосещённая вершина получает кандидата в родители -
+// минимальный номер соседа во фронте (атомарный минимум), затем только этот
+// родитель захватывает её. Родители и порядок не зависят от числа потоков
+// и расписания. Без него родитель - тот, кто первым захватил вершину.
+bfs_tree parallel_bfs_tree(const std::vector<std::vector<int>>& graph, int start, bool deterministic = true);
+bfs_tree parallel_bfs_tree(const csr_graph& graph, int start, bool deterministic = true);
+bfs_tree parallel_bfs_tree(const csr_view& graph, int start, bool deterministic = true);
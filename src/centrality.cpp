@@ -0,0 +1,139 @@
+#include "centrality.h"
+#include "arena.h"
+#include "frontier.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace {
+// Рабочее пространство потока: расстояния сбрасываются только в посещённых
+// вершинах, суммы копятся по всем источникам потока
+struct worker_sums {
+    explicit worker_sums(size_t n) : dist(n, -1), sums(n, 0.0) {}
+
+    arena::array<int> dist;
+    std::vector<int> queue;
+    arena::array<double> sums;
+};
+
+void inter_source(const std::vector<std::vector<int>>& graph, const std::vector<int>& sources,
+                  std::vector<double>& res) {
+    size_t n = graph.size();
+    std::vector<std::unique_ptr<worker_sums>> workers(parlay::num_workers());
+
+    parlay::parallel_for(0, sources.size(),
+        [&] (size_t i) {
+            std::unique_ptr<worker_sums>& w = workers[parlay::worker_id()];
+            if (!w) w = std::make_unique<worker_sums>(n);
+
+            arena::array<int>& dist = w->dist;
+            std::vector<int>& queue = w->queue;
+            queue.clear();
+            queue.push_back(sources[i]);
+            dist[sources[i]] = 0;
+
+            for (size_t head = 0; head < queue.size(); head++) {
+                int v = queue[head];
+                for (int u : graph[v]) {
+                    if (dist[u] == -1) {
+                        dist[u] = dist[v] + 1;
+                        w->sums[u] += 1.0 / dist[u];
+                        queue.push_back(u);
+                    }
+                }
+            }
+
+            for (int v : queue) dist[v] = -1;
+        }, 1
+    );
+
+    parlay::parallel_for(0, n,
+        [&] (size_t v) {
+            double acc = 0;
+            for (const auto& w : workers) {
+                if (w) acc += w->sums[v];
+            }
+            res[v] = acc;
+        }
+    );
+}
+
+void intra_source(const std::vector<std::vector<int>>& graph, const std::vector<int>& sources,
+                  std::vector<double>& res) {
+    size_t n = graph.size();
+    arena::array<std::atomic<uint32_t>> stamp_holder(n);
+    std::atomic<uint32_t>* stamp = stamp_holder.get();
+
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            stamp[i].store(0, std::memory_order_relaxed);
+        }
+    );
+
+    frontier::buffers buf(n);
+    double* sums = res.data();
+    uint32_t epoch = 0;
+
+    for (int s : sources) {
+        epoch++;
+        stamp[s].store(epoch, std::memory_order_relaxed);
+        buf.current[0] = static_cast<size_t>(s);
+        buf.current_size = 1;
+
+        for (int level = 1; buf.current_size > 0; level++) {
+            double contribution = 1.0 / level;
+            // Вершину захватывает ровно один поток, поэтому сумма пишется без атомиков
+            frontier::expand(graph, buf,
+                [stamp, epoch, sums, contribution] (size_t, size_t k) {
+                    uint32_t cur = stamp[k].load(std::memory_order_relaxed);
+                    if (cur != epoch && stamp[k].compare_exchange_strong(cur, epoch)) {
+                        sums[k] += contribution;
+                        return true;
+                    }
+                    return false;
+                }
+            );
+        }
+    }
+}
+}
+
+std::vector<double> harmonic_centrality(const std::vector<std::vector<int>>& graph,
+                                        const std::vector<int>& sources,
+                                        centrality_stats* stats,
+                                        centrality_mode mode,
+                                        size_t inter_source_limit) {
+    size_t n = graph.size();
+    std::vector<double> res(n, 0.0);
+
+    if (mode == centrality_mode::automatic) {
+        mode = n <= inter_source_limit ? centrality_mode::inter_source : centrality_mode::intra_source;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    if (n > 0 && !sources.empty()) {
+        if (mode == centrality_mode::inter_source) {
+            inter_source(graph, sources, res);
+        } else {
+            intra_source(graph, sources, res);
+        }
+
+        double scale = static_cast<double>(n) / sources.size();
+        parlay::parallel_for(0, n,
+            [&res, scale] (size_t v) {
+                res[v] *= scale;
+            }
+        );
+    }
+
+    if (stats != nullptr) {
+        stats->sources = sources.size();
+        stats->mode = mode;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        stats->sources_per_sec = stats->seconds > 0 ? sources.size() / stats->seconds : 0;
+    }
+
+    return res;
+}
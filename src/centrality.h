@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+enum class centrality_mode {
+    automatic,
+    // Источники раздаются потокам целиком, у каждого потока свои суммы
+    inter_source,
+    // Источники по очереди, каждый обход параллелен по уровням
+    intra_source
+};
+
+struct centrality_stats {
+    size_t sources = 0;
+    centrality_mode mode = centrality_mode::automatic;
+    double seconds = 0;
+    double sources_per_sec = 0;
+};
+
+// Гармоническая центральность неориентированного графа по выборке источников:
+// h[v] = n / |sources| * сумма 1 / d(s, v) по источникам s != v, для всех
+// вершин в качестве источников ответ точный. Суммы копятся прямо во время
+// обхода, векторы расстояний не строятся. В автоматическом режиме графы до
+// inter_source_limit вершин обрабатываются параллельно по источникам.
+std::vector<double> harmonic_centrality(const std::vector<std::vector<int>>& graph,
+                                        const std::vector<int>& sources,
+                                        centrality_stats* stats = nullptr,
+                                        centrality_mode mode = centrality_mode::automatic,
+                                        size_t inter_source_limit = 1 << 17);
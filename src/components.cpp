@@ -0,0 +1,154 @@
+#include "components.h"
+#include "arena.h"
+#include "frontier.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+size_t max_degree_vertex(const std::vector<std::vector<int>>& graph) {
+    size_t n = graph.size();
+    size_t block = 4096;
+    size_t blocks = (n + block - 1) / block;
+    std::vector<size_t> best(blocks);
+
+    parlay::parallel_for(0, blocks,
+        [&] (size_t b) {
+            size_t lo = b * block;
+            size_t hi = std::min(n, lo + block);
+            size_t arg = lo;
+            for (size_t v = lo + 1; v < hi; v++) {
+                if (graph[v].size() > graph[arg].size()) arg = v;
+            }
+            best[b] = arg;
+        }
+    );
+
+    size_t arg = best[0];
+    for (size_t b = 1; b < blocks; b++) {
+        if (graph[best[b]].size() > graph[arg].size()) arg = best[b];
+    }
+    return arg;
+}
+
+int find_root(std::atomic<int>* parent, int v) {
+    while (true) {
+        int p = parent[v].load(std::memory_order_relaxed);
+        if (p == v) return v;
+        int gp = parent[p].load(std::memory_order_relaxed);
+        if (gp != p) {
+            // Сжатие путей делением пополам, гонки безопасны: ссылка всегда ведёт к предку
+            parent[v].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        }
+        v = gp;
+    }
+}
+
+void unite(std::atomic<int>* parent, int u, int v) {
+    while (true) {
+        int ru = find_root(parent, u);
+        int rv = find_root(parent, v);
+        if (ru == rv) return;
+        // Подвешиваем больший корень к меньшему, так циклы невозможны
+        if (ru < rv) std::swap(ru, rv);
+        int expected = ru;
+        if (parent[ru].compare_exchange_strong(expected, rv)) return;
+    }
+}
+}
+
+components_result connected_components(const std::vector<std::vector<int>>& graph) {
+    size_t n = graph.size();
+    components_result result;
+    result.component.assign(n, -1);
+
+    if (n == 0) return result;
+
+    std::vector<int>& comp = result.component;
+
+    // Гигантская компонента почти наверняка содержит вершину максимальной степени,
+    // её размечаем обычным BFS по фронтам
+    size_t start = max_degree_vertex(graph);
+
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
+
+    visited.claim(start);
+    comp[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+    size_t giant_size = 1;
+
+    while (buf.current_size > 0) {
+        giant_size += frontier::expand(graph, buf,
+            [&visited, &comp] (size_t, size_t k) {
+                if (visited.claim(k)) {
+                    comp[k] = 0;
+                    return true;
+                }
+                return false;
+            }
+        );
+    }
+
+    result.sizes.push_back(giant_size);
+    if (giant_size == n) return result;
+
+    // Хвост доразмечаем параллельным union-find по оставшимся рёбрам
+    arena::array<std::atomic<int>> parent(n);
+    std::atomic<int>* par = parent.get();
+
+    parlay::parallel_for(0, n,
+        [=] (size_t v) {
+            par[v].store(static_cast<int>(v), std::memory_order_relaxed);
+        }
+    );
+
+    parlay::parallel_for(0, n,
+        [&graph, &comp, par] (size_t v) {
+            if (comp[v] == 0) return;
+            for (int u : graph[v]) {
+                if (static_cast<size_t>(u) < v) unite(par, static_cast<int>(v), u);
+            }
+        }
+    );
+
+    // Корни хвостовых компонент нумеруем подряд через scan
+    size_t* roots = buf.sizes;
+    size_t roots_size = buf.sizes_capacity();
+
+    parlay::parallel_for(0, roots_size,
+        [&comp, par, roots, n] (size_t v) {
+            roots[v] = (v < n && comp[v] != 0 && par[v].load(std::memory_order_relaxed) == static_cast<int>(v)) ? 1 : 0;
+        }
+    );
+
+    size_t tail_count = frontier::scan(roots, roots_size);
+
+    std::unique_ptr<std::atomic<size_t>[]> tail_sizes(new std::atomic<size_t>[tail_count]);
+    std::atomic<size_t>* counts = tail_sizes.get();
+
+    parlay::parallel_for(0, tail_count,
+        [=] (size_t c) {
+            counts[c].store(0, std::memory_order_relaxed);
+        }
+    );
+
+    parlay::parallel_for(0, n,
+        [&comp, par, roots, counts] (size_t v) {
+            if (comp[v] == 0) return;
+            size_t id = roots[find_root(par, static_cast<int>(v))];
+            comp[v] = static_cast<int>(id + 1);
+            counts[id].fetch_add(1, std::memory_order_relaxed);
+        }
+    );
+
+    result.sizes.resize(tail_count + 1);
+    parlay::parallel_for(0, tail_count,
+        [&result, counts] (size_t c) {
+            result.sizes[c + 1] = counts[c].load(std::memory_order_relaxed);
+        }
+    );
+
+    return result;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct components_result {
+    // component[v] - номер компоненты вершины v, номера идут подряд с нуля,
+    // компонента с вершиной максимальной степени получает номер 0
+    std::vector<int> component;
+    std::vector<size_t> sizes;
+};
+
+// Граф считается неориентированным (списки смежности симметричны)
+components_result connected_components(const std::vector<std::vector<int>>& graph);
@@ -0,0 +1,40 @@
+#include "csr_graph.h"
+#include "frontier.h"
+#include <parlay/parallel.h>
+#include <utility>
+
+csr_graph::csr_graph(arena::array<uint64_t> offsets, arena::array<int> targets)
+    : offsets_(std::move(offsets)), targets_(std::move(targets)) {}
+
+csr_graph::csr_graph(const std::vector<std::vector<int>>& graph) {
+    size_t n = graph.size();
+    size_t len = frontier::round_up_pow2(n + 1);
+
+    std::vector<size_t> degrees(len, 0);
+    size_t* deg = degrees.data();
+    parlay::parallel_for(0, n,
+        [&graph, deg] (size_t v) {
+            deg[v] = graph[v].size();
+        }
+    );
+    size_t m = frontier::scan(deg, len);
+
+    offsets_ = arena::array<uint64_t>(n + 1);
+    targets_ = arena::array<int>(m);
+    uint64_t* offsets = offsets_.data();
+    int* targets = targets_.data();
+
+    parlay::parallel_for(0, n + 1,
+        [=] (size_t v) {
+            offsets[v] = deg[v];
+        }
+    );
+    parlay::parallel_for(0, n,
+        [&graph, offsets, targets] (size_t v) {
+            const std::vector<int>& adj = graph[v];
+            for (size_t j = 0; j < adj.size(); j++) {
+                targets[offsets[v] + j] = adj[j];
+            }
+        }
+    );
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Граф в формате CSR: списки смежности подряд в targets, offsets[v] - начало
+// списка вершины v. Оба массива лежат в арене (см. arena.h).
+class csr_graph {
+public:
+    class neighbor_range {
+    public:
+        neighbor_range(const int* begin, const int* end) : begin_(begin), end_(end) {}
+
+        size_t size() const { return static_cast<size_t>(end_ - begin_); }
+        int operator[](size_t i) const { return begin_[i]; }
+        const int* begin() const { return begin_; }
+        const int* end() const { return end_; }
+
+    private:
+        const int* begin_;
+        const int* end_;
+    };
+
+    csr_graph() = default;
+    csr_graph(arena::array<uint64_t> offsets, arena::array<int> targets);
+
+    explicit csr_graph(const std::vector<std::vector<int>>& graph);
+
+    size_t size() const { return offsets_.size() == 0 ? 0 : offsets_.size() - 1; }
+    size_t num_edges() const { return targets_.size(); }
+
+    neighbor_range operator[](size_t v) const {
+        return neighbor_range(targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1]);
+    }
+
+    const uint64_t* offsets() const { return offsets_.data(); }
+    const int* targets() const { return targets_.data(); }
+
+private:
+    arena::array<uint64_t> offsets_;
+    arena::array<int> targets_;
+};
+
+// CSR поверх чужих массивов без копирования (например, буферов из Python).
+// offsets - n + 1 элементов, массивы должны жить, пока идёт обход.
+class csr_view {
+public:
+    csr_view(const uint64_t* offsets, const int* targets, size_t n)
+        : offsets_(offsets), targets_(targets), n_(n) {}
+
+    explicit csr_view(const csr_graph& graph)
+        : offsets_(graph.offsets()), targets_(graph.targets()), n_(graph.size()) {}
+
+    size_t size() const { return n_; }
+    size_t num_edges() const { return n_ == 0 ? 0 : offsets_[n_]; }
+
+    csr_graph::neighbor_range operator[](size_t v) const {
+        return csr_graph::neighbor_range(targets_ + offsets_[v], targets_ + offsets_[v + 1]);
+    }
+
+private:
+    const uint64_t* offsets_;
+    const int* targets_;
+    size_t n_;
+};
@@ -0,0 +1,157 @@
+#include "diameter.h"
+#include "arena.h"
+#include "frontier.h"
+#include <algorithm>
+
+namespace {
+// Многократный BFS на общих буферах: между обходами сбрасываются только
+// флаги вершин, достигнутых предыдущим обходом. Уровни последнего обхода
+// хранятся подряд в order, level_start[d] - начало уровня d.
+class sweeper {
+public:
+    explicit sweeper(const std::vector<std::vector<int>>& graph)
+        : graph_(graph),
+          visited_(graph.size()),
+          buf_(graph.size()),
+          order(graph.size()),
+          parent(graph.size()) {}
+
+    int run(size_t source) {
+        std::atomic_flag* flags = visited_.data();
+        size_t* prev = order.data();
+        parlay::parallel_for(0, reached,
+            [=] (size_t i) {
+                flags[prev[i]].clear();
+            }
+        );
+
+        traversals++;
+        visited_.claim(source);
+        parent[source] = source;
+        buf_.current[0] = source;
+        buf_.current_size = 1;
+        level_start.assign(1, 0);
+        reached = 0;
+
+        while (buf_.current_size > 0) {
+            size_t* current = buf_.current;
+            size_t* dst = order.data() + reached;
+            parlay::parallel_for(0, buf_.current_size,
+                [=] (size_t i) {
+                    dst[i] = current[i];
+                }
+            );
+            reached += buf_.current_size;
+            level_start.push_back(reached);
+
+            const frontier::visited_flags& visited = visited_;
+            size_t* par = parent.data();
+            frontier::expand(graph_, buf_,
+                [&visited, par] (size_t from, size_t k) {
+                    if (visited.claim(k)) {
+                        par[k] = from;
+                        return true;
+                    }
+                    return false;
+                }
+            );
+        }
+
+        return static_cast<int>(level_start.size()) - 2;
+    }
+
+    size_t farthest() const { return order[reached - 1]; }
+
+    // Вершина пути от источника последнего обхода до v на расстоянии steps от v
+    size_t ancestor(size_t v, int steps) const {
+        for (int i = 0; i < steps; i++) {
+            v = parent[v];
+        }
+        return v;
+    }
+
+private:
+    const std::vector<std::vector<int>>& graph_;
+    frontier::visited_flags visited_;
+    frontier::buffers buf_;
+
+public:
+    arena::array<size_t> order;
+    std::vector<size_t> level_start;
+    arena::array<size_t> parent;
+    size_t reached = 0;
+    size_t traversals = 0;
+};
+
+size_t max_degree_vertex(const std::vector<std::vector<int>>& graph) {
+    size_t arg = 0;
+    for (size_t v = 1; v < graph.size(); v++) {
+        if (graph[v].size() > graph[arg].size()) arg = v;
+    }
+    return arg;
+}
+}
+
+diameter_bounds estimate_diameter(const std::vector<std::vector<int>>& graph, size_t max_traversals) {
+    diameter_bounds bounds;
+    if (graph.empty()) return bounds;
+
+    sweeper bfs(graph);
+    size_t center = max_degree_vertex(graph);
+    bounds.upper = INT_MAX;
+
+    // 4-sweep: дважды уходим в дальнюю вершину и берём середину найденного пути
+    for (int sweep = 0; sweep < 2 && bfs.traversals + 2 <= max_traversals; sweep++) {
+        int e = bfs.run(center);
+        bounds.lower = std::max(bounds.lower, e);
+        bounds.upper = std::min(bounds.upper, 2 * e);
+
+        size_t a = bfs.farthest();
+        e = bfs.run(a);
+        bounds.lower = std::max(bounds.lower, e);
+        bounds.upper = std::min(bounds.upper, 2 * e);
+
+        center = bfs.ancestor(bfs.farthest(), e / 2);
+    }
+
+    if (bfs.traversals >= max_traversals || bounds.lower == bounds.upper) {
+        bounds.traversals = bfs.traversals;
+        return bounds;
+    }
+
+    int e = bfs.run(center);
+    bounds.lower = std::max(bounds.lower, e);
+    bounds.upper = std::min(bounds.upper, 2 * e);
+
+    // Слои из центра понадобятся целиком, последующие обходы затирают order
+    std::vector<size_t> layers(bfs.order.begin(), bfs.order.begin() + bfs.reached);
+    std::vector<size_t> layer_start = bfs.level_start;
+
+    for (int i = e; i > 0 && bounds.lower < bounds.upper; i--) {
+        // Любая пара, не затрагивающая слои >= i, удалена не больше чем на 2 * (i - 1)
+        int layer_max = 0;
+        for (size_t j = layer_start[i]; j < layer_start[i + 1]; j++) {
+            if (bfs.traversals >= max_traversals) {
+                bounds.lower = std::max(bounds.lower, layer_max);
+                bounds.traversals = bfs.traversals;
+                return bounds;
+            }
+            layer_max = std::max(layer_max, bfs.run(layers[j]));
+        }
+
+        bounds.lower = std::max(bounds.lower, layer_max);
+        if (bounds.lower > 2 * (i - 1)) {
+            bounds.upper = bounds.lower;
+        } else {
+            bounds.upper = std::min(bounds.upper, 2 * (i - 1));
+        }
+    }
+
+    bounds.traversals = bfs.traversals;
+    return bounds;
+}
+
+int eccentricity(const std::vector<std::vector<int>>& graph, int v) {
+    sweeper bfs(graph);
+    return bfs.run(static_cast<size_t>(v));
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct diameter_bounds {
+    int lower = 0;
+    int upper = 0;
+    size_t traversals = 0;
+
+    bool exact() const { return lower == upper; }
+};
+
+// Диаметр компоненты, содержащей вершину максимальной степени. 4-sweep даёт
+// центральную вершину u, затем iFUB перебирает слои BFS из u от дальнего к
+// ближнему, поднимая нижнюю границу эксцентриситетами вершин слоя и опуская
+// верхнюю до 2 * (номер слоя - 1). Обе границы гарантированы; при
+// исчерпании max_traversals обходов возвращается текущий интервал.
+diameter_bounds estimate_diameter(const std::vector<std::vector<int>>& graph,
+                                  size_t max_traversals = SIZE_MAX);
+
+// Эксцентриситет вершины в её компоненте
+int eccentricity(const std::vector<std::vector<int>>& graph, int v);
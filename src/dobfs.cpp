@@ -0,0 +1,253 @@
+#include "dobfs.h"
+#include "arena.h"
+#include "frontier.h"
+#include "tuning.h"
+#include <parlay/parallel.h>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PARBFS_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Вершин на одну задачу шага снизу вверх, кратно 32 - задача пишет свои слова маски
+constexpr size_t chunk_vertices = 2048;
+
+using find_parent_fn = size_t (*)(const int* neighbors, size_t degree, const uint32_t* bits);
+
+inline bool test_bit(const uint32_t* bits, int v) {
+    return (bits[static_cast<uint32_t>(v) >> 5] >> (v & 31)) & 1;
+}
+
+// Индекс первого соседа во фронте или degree, если такого нет
+size_t find_parent_scalar(const int* neighbors, size_t degree, const uint32_t* bits) {
+    for (size_t i = 0; i < degree; i++) {
+        if (test_bit(bits, neighbors[i])) return i;
+    }
+    return degree;
+}
+
+#ifdef PARBFS_X86_DISPATCH
+
+__attribute__((target("avx2")))
+size_t find_parent_avx2(const int* neighbors, size_t degree, const uint32_t* bits) {
+    const __m256i low = _mm256_set1_epi32(31);
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 8 <= degree; i += 8) {
+        __m256i ids = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(neighbors + i));
+        __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(bits), _mm256_srli_epi32(ids, 5), 4);
+        __m256i hit = _mm256_and_si256(_mm256_srlv_epi32(words, _mm256_and_si256(ids, low)), one);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(hit, one)));
+        if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    for (; i < degree; i++) {
+        if (test_bit(bits, neighbors[i])) return i;
+    }
+    return degree;
+}
+
+__attribute__((target("avx512f")))
+size_t find_parent_avx512(const int* neighbors, size_t degree, const uint32_t* bits) {
+    const __m512i low = _mm512_set1_epi32(31);
+    const __m512i one = _mm512_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 16 <= degree; i += 16) {
+        __m512i ids = _mm512_loadu_si512(neighbors + i);
+        __m512i words = _mm512_i32gather_epi32(_mm512_srli_epi32(ids, 5), bits, 4);
+        __mmask16 mask = _mm512_test_epi32_mask(_mm512_srlv_epi32(words, _mm512_and_si512(ids, low)), one);
+        if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    for (; i < degree; i++) {
+        if (test_bit(bits, neighbors[i])) return i;
+    }
+    return degree;
+}
+
+#endif
+
+find_parent_fn kernel_for(simd_level level) {
+    switch (std::min(level, best_simd_level())) {
+#ifdef PARBFS_X86_DISPATCH
+    case simd_level::avx512: return find_parent_avx512;
+    case simd_level::avx2: return find_parent_avx2;
+#endif
+    default: return find_parent_scalar;
+    }
+}
+
+// Степени захваченных вершин копятся по потокам прямо в шаге сверху вниз,
+// чтобы не делать лишний проход по фронту на каждом уровне
+struct alignas(64) edge_counter {
+    size_t value = 0;
+};
+
+}
+
+simd_level best_simd_level() {
+#ifdef PARBFS_X86_DISPATCH
+    static const simd_level level =
+        __builtin_cpu_supports("avx512f") ? simd_level::avx512 :
+        __builtin_cpu_supports("avx2") ? simd_level::avx2 : simd_level::scalar;
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+const char* simd_level_name(simd_level level) {
+    switch (level) {
+    case simd_level::avx512: return "avx512";
+    case simd_level::avx2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+std::vector<int> direction_optimizing_bfs(const csr_graph& graph, int start_int, simd_level kernel, dobfs_stats* stats) {
+    size_t n = graph.size();
+
+    std::vector<int> res(n, -1);
+    size_t start = static_cast<size_t>(start_int);
+
+    if (n == 0) return res;
+
+    find_parent_fn find_parent = kernel_for(kernel);
+    int* dist = res.data();
+
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
+
+    // Маски текущего и следующего фронта для шагов снизу вверх
+    size_t words = (n + 31) / 32;
+    arena::array<uint32_t> bits_holder(2 * words, 0);
+    uint32_t* bits = bits_holder.data();
+    uint32_t* next = bits_holder.data() + words;
+
+    size_t chunks = (n + chunk_vertices - 1) / chunk_vertices;
+    std::vector<size_t> chunk_counts(frontier::round_up_pow2(chunks), 0);
+    std::vector<size_t> chunk_edges(frontier::round_up_pow2(chunks), 0);
+    size_t* counts = chunk_counts.data();
+    size_t* edges = chunk_edges.data();
+
+    visited.claim(start);
+    dist[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+
+    // Пороги переключения, по умолчанию из статьи Beamer et al.
+    size_t alpha = std::max<size_t>(current_tuning().dobfs_alpha, 1);
+    size_t beta = std::max<size_t>(current_tuning().dobfs_beta, 1);
+
+    size_t unexplored_edges = graph.num_edges();
+    size_t front_edges = graph[start].size();
+    size_t prev_front_edges = 0;
+    int level = 0;
+    bool bottom_up = false;
+
+    std::vector<edge_counter> claimed_edges(parlay::num_workers());
+    edge_counter* claimed = claimed_edges.data();
+
+    dobfs_stats local_stats;
+    if (stats == nullptr) stats = &local_stats;
+    *stats = dobfs_stats();
+
+    while (buf.current_size > 0) {
+        stats->levels++;
+        stats->max_frontier = std::max(stats->max_frontier, buf.current_size);
+        unexplored_edges -= std::min(unexplored_edges, front_edges);
+
+        // Только на растущем фронте: на хвосте обхода рёбер непосещённых мало,
+        // и без этого условия направление переключалось бы каждый уровень
+        if (!bottom_up && front_edges > prev_front_edges && front_edges > unexplored_edges / alpha) {
+            // Маска фронта по расстояниям: вершины уровня level
+            parlay::parallel_for(0, words,
+                [=] (size_t w) {
+                    uint32_t word = 0;
+                    size_t end = std::min(n, (w + 1) * 32);
+                    for (size_t v = w * 32; v < end; v++) {
+                        if (dist[v] == level) word |= uint32_t(1) << (v % 32);
+                    }
+                    bits[w] = word;
+                }
+            );
+            bottom_up = true;
+        }
+
+        if (bottom_up) {
+            stats->bottom_up_levels++;
+            parlay::parallel_for(0, chunks,
+                [&graph, &visited, find_parent, bits, next, dist, counts, edges, n, level] (size_t c) {
+                    size_t found = 0;
+                    size_t found_edges = 0;
+                    size_t end = std::min(n, (c + 1) * chunk_vertices);
+                    for (size_t w = c * chunk_vertices / 32; w * 32 < end; w++) {
+                        uint32_t word = 0;
+                        for (size_t v = w * 32; v < std::min(end, (w + 1) * 32); v++) {
+                            if (dist[v] >= 0) continue;
+                            auto adj = graph[v];
+                            if (find_parent(adj.begin(), adj.size(), bits) < adj.size()) {
+                                dist[v] = level + 1;
+                                visited.claim(v);
+                                word |= uint32_t(1) << (v % 32);
+                                found++;
+                                found_edges += adj.size();
+                            }
+                        }
+                        next[w] = word;
+                    }
+                    counts[c] = found;
+                    edges[c] = found_edges;
+                }
+            );
+            std::swap(bits, next);
+
+            // scan превращает хвост до степени двойки в префиксные суммы
+            std::fill(counts + chunks, counts + chunk_counts.size(), 0);
+            std::fill(edges + chunks, edges + chunk_edges.size(), 0);
+
+            prev_front_edges = front_edges;
+            front_edges = frontier::scan(edges, chunk_edges.size());
+            size_t found = frontier::scan(counts, chunk_counts.size());
+            level++;
+            buf.current_size = found;
+
+            if (found == 0 || found >= n / beta) continue;
+
+            // Фронт снова мал: список вершин из маски, по смещениям блоков
+            size_t* current = buf.current;
+            parlay::parallel_for(0, chunks,
+                [=] (size_t c) {
+                    size_t pos = counts[c];
+                    size_t end = std::min(n, (c + 1) * chunk_vertices);
+                    for (size_t v = c * chunk_vertices; v < end; v++) {
+                        if ((bits[v / 32] >> (v % 32)) & 1) current[pos++] = v;
+                    }
+                }
+            );
+            bottom_up = false;
+            continue;
+        }
+
+        for (auto& c : claimed_edges) c.value = 0;
+        frontier::expand(graph, buf,
+            [&graph, &visited, dist, claimed] (size_t from, size_t k) {
+                if (visited.claim(k)) {
+                    dist[k] = dist[from] + 1;
+                    claimed[parlay::worker_id()].value += graph[k].size();
+                    return true;
+                }
+                return false;
+            }
+        );
+        level++;
+        prev_front_edges = front_edges;
+        front_edges = 0;
+        for (const auto& c : claimed_edges) front_edges += c.value;
+    }
+
+    return res;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "csr_graph.h"
+#include <vector>
+
+// Ядро поиска родителя в шаге снизу вверх: непосещённая вершина просматривает
+// соседей блоками и ищет первого, чей бит стоит в битовой маске фронта
+enum class simd_level { scalar, avx2, avx512 };
+
+// Лучшее ядро, которое поддерживает процессор (проверяется во время работы)
+simd_level best_simd_level();
+const char* simd_level_name(simd_level level);
+
+struct dobfs_stats {
+    // Шагов обхода (по одному на уровень), из них снизу вверх
+    size_t levels = 0;
+    size_t bottom_up_levels = 0;
+    // Самый большой фронт
+    size_t max_frontier = 0;
+};
+
+// BFS с переключением направления (Beamer): сверху вниз, пока рёбер фронта
+// мало относительно рёбер непосещённых, иначе снизу вверх по битовой маске.
+// Ядро выше поддерживаемого процессором понижается до best_simd_level().
+std::vector<int> direction_optimizing_bfs(const csr_graph& graph, int start,
+                                          simd_level kernel = best_simd_level(),
+                                          dobfs_stats* stats = nullptr);
@@ -0,0 +1,235 @@
+#include "dynbfs.h"
+#include "parbfs.h"
+#include <algorithm>
+
+namespace {
+bool add_arc(std::vector<int>& list, int v) {
+    if (std::find(list.begin(), list.end(), v) != list.end()) return false;
+    list.push_back(v);
+    return true;
+}
+
+bool remove_arc(std::vector<int>& list, int v) {
+    auto it = std::find(list.begin(), list.end(), v);
+    if (it == list.end()) return false;
+    *it = list.back();
+    list.pop_back();
+    return true;
+}
+}
+
+dynamic_bfs::dynamic_bfs(std::vector<std::vector<int>> graph, int source)
+    : graph_(std::move(graph)),
+      source_(source),
+      n_(graph_.size()),
+      version_(new_graph_version()),
+      dist_(graph_.size()),
+      saved_(graph_.size()),
+      touched_(graph_.size(), 0),
+      invalid_(graph_.size(), 0),
+      queued_(graph_.size()),
+      buf_(graph_.size()) {
+    std::vector<int> initial = parallel_bfs(graph_, source_);
+    std::atomic<int>* dist = dist_.get();
+
+    parlay::parallel_for(0, n_,
+        [&initial, dist] (size_t i) {
+            dist[i].store(initial[i], std::memory_order_relaxed);
+        }
+    );
+}
+
+std::vector<int> dynamic_bfs::distances() const {
+    std::vector<int> res(n_);
+    parlay::parallel_for(0, n_,
+        [this, &res] (size_t i) {
+            res[i] = distance(static_cast<int>(i));
+        }
+    );
+    return res;
+}
+
+std::vector<int> dynamic_bfs::apply(const std::vector<edge>& insertions, const std::vector<edge>& deletions) {
+    std::vector<edge> removed;
+    bool added = false;
+    for (const auto& [u, v] : deletions) {
+        if (u != v && remove_arc(graph_[u], v)) {
+            remove_arc(graph_[v], u);
+            removed.emplace_back(u, v);
+        }
+    }
+    for (const auto& [u, v] : insertions) {
+        if (u == v) continue;
+        if (add_arc(graph_[u], v)) {
+            add_arc(graph_[v], u);
+            added = true;
+        }
+    }
+    if (added || !removed.empty()) version_ = new_graph_version();
+
+    if (!removed.empty()) invalidate(removed);
+    relax(insertions);
+
+    std::vector<int> changed;
+    for (int v : touched_list_) {
+        if (touched_[v] && distance(v) != saved_[v]) changed.push_back(v);
+        touched_[v] = 0;
+        invalid_[v] = 0;
+    }
+    touched_list_.clear();
+    invalid_list_.clear();
+
+    return changed;
+}
+
+// Удаление ребра может сделать недостижимым кратчайший путь. Идём по уровням
+// вниз от концов удалённых рёбер и помечаем вершины, у которых не осталось
+// валидного родителя на предыдущем уровне; их расстояния сбрасываются в -1.
+void dynamic_bfs::invalidate(const std::vector<edge>& deletions) {
+    std::atomic<int>* dist = dist_.get();
+    std::atomic_flag* queued = queued_.data();
+
+    std::vector<int> candidates;
+    for (const auto& [u, v] : deletions) {
+        int du = distance(u);
+        int dv = distance(v);
+        if (du != -1 && dv == du + 1) candidates.push_back(v);
+        if (dv != -1 && du == dv + 1) candidates.push_back(u);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [this] (int a, int b) {
+            return distance(a) < distance(b);
+        }
+    );
+
+    std::vector<int> queued_list;
+    size_t next_candidate = 0;
+    buf_.current_size = 0;
+
+    while (buf_.current_size > 0 || next_candidate < candidates.size()) {
+        int level = buf_.current_size > 0
+            ? distance(static_cast<int>(buf_.current[0]))
+            : distance(candidates[next_candidate]);
+
+        while (next_candidate < candidates.size() && distance(candidates[next_candidate]) == level) {
+            int v = candidates[next_candidate++];
+            if (queued_.claim(v)) buf_.current[buf_.current_size++] = v;
+        }
+
+        size_t* current = buf_.current;
+        char* invalid = invalid_.data();
+        const auto& graph = graph_;
+        int source = source_;
+
+        parlay::parallel_for(0, buf_.current_size,
+            [&graph, current, dist, invalid, level, source] (size_t i) {
+                size_t w = current[i];
+                if (static_cast<int>(w) == source) return;
+                for (int x : graph[w]) {
+                    if (dist[x].load(std::memory_order_relaxed) == level - 1 && !invalid[x]) return;
+                }
+                invalid[w] = 1;
+            }
+        );
+
+        for (size_t i = 0; i < buf_.current_size; i++) {
+            int w = static_cast<int>(current[i]);
+            queued_list.push_back(w);
+            if (invalid[w]) invalid_list_.push_back(w);
+        }
+
+        const frontier::visited_flags& marks = queued_;
+        frontier::expand(graph_, buf_,
+            [dist, invalid, &marks] (size_t from, size_t k) {
+                if (!invalid[from]) return false;
+                int d = dist[from].load(std::memory_order_relaxed);
+                return dist[k].load(std::memory_order_relaxed) == d + 1 && marks.claim(k);
+            }
+        );
+    }
+
+    for (int v : queued_list) queued[v].clear();
+
+    for (int v : invalid_list_) {
+        saved_[v] = distance(v);
+        touched_[v] = 1;
+        touched_list_.push_back(v);
+        dist[v].store(-1, std::memory_order_relaxed);
+    }
+}
+
+// Уровневая релаксация от вершин, у которых могли появиться более короткие
+// пути: концы вставленных рёбер и достижимые соседи сброшенных вершин.
+// Вершины обрабатываются по возрастанию расстояния, поэтому каждая
+// захватывается не более одного раза и получает точное расстояние.
+void dynamic_bfs::relax(const std::vector<edge>& insertions) {
+    std::atomic<int>* dist = dist_.get();
+    std::atomic_flag* queued = queued_.data();
+
+    std::vector<int> seeds;
+    for (const auto& [u, v] : insertions) {
+        if (u == v) continue;
+        if (distance(u) != -1 && queued_.claim(u)) seeds.push_back(u);
+        if (distance(v) != -1 && queued_.claim(v)) seeds.push_back(v);
+    }
+
+    if (!invalid_list_.empty()) {
+        buf_.current_size = invalid_list_.size();
+        std::copy(invalid_list_.begin(), invalid_list_.end(), buf_.current);
+        const frontier::visited_flags& marks = queued_;
+        frontier::expand(graph_, buf_,
+            [dist, &marks] (size_t, size_t k) {
+                return dist[k].load(std::memory_order_relaxed) != -1 && marks.claim(k);
+            }
+        );
+        seeds.insert(seeds.end(), buf_.current, buf_.current + buf_.current_size);
+    }
+
+    for (int v : seeds) queued[v].clear();
+    if (seeds.empty()) return;
+
+    // Расстояния семян запоминаем заранее: во время релаксации они могут уменьшиться
+    std::vector<std::pair<int, int>> order(seeds.size());
+    for (size_t i = 0; i < seeds.size(); i++) {
+        order[i] = {distance(seeds[i]), seeds[i]};
+    }
+    std::sort(order.begin(), order.end());
+
+    char* invalid = invalid_.data();
+    int* saved = saved_.data();
+    size_t next_seed = 0;
+    buf_.current_size = 0;
+    int level = order[0].first;
+
+    while (buf_.current_size > 0 || next_seed < order.size()) {
+        if (buf_.current_size == 0) level = order[next_seed].first;
+
+        while (next_seed < order.size() && order[next_seed].first == level) {
+            int v = order[next_seed++].second;
+            // Семя, до которого уже нашёлся путь короче, обработано раньше
+            if (distance(v) == level) buf_.current[buf_.current_size++] = v;
+        }
+
+        frontier::expand(graph_, buf_,
+            [dist, invalid, saved, level] (size_t, size_t k) {
+                int cur = dist[k].load(std::memory_order_relaxed);
+                while (cur == -1 || cur > level + 1) {
+                    if (dist[k].compare_exchange_weak(cur, level + 1)) {
+                        if (!invalid[k]) saved[k] = cur;
+                        return true;
+                    }
+                }
+                return false;
+            }
+        );
+
+        for (size_t i = 0; i < buf_.current_size; i++) {
+            int v = static_cast<int>(buf_.current[i]);
+            if (!touched_[v]) {
+                touched_[v] = 1;
+                touched_list_.push_back(v);
+            }
+        }
+        level++;
+    }
+}
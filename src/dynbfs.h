@@ -0,0 +1,51 @@
+#pragma once
+
+#include "arena.h"
+#include "frontier.h"
+#include "graph_version.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Расстояния от фиксированного источника в неориентированном графе,
+// поддерживаемые при пакетных вставках и удалениях рёбер.
+// Число вершин фиксировано при создании.
+class dynamic_bfs {
+public:
+    using edge = std::pair<int, int>;
+
+    dynamic_bfs(std::vector<std::vector<int>> graph, int source);
+
+    // Применяет пакет изменений (сначала удаления, затем вставки) и чинит
+    // только затронутую область.
+    // Возвращает вершины, расстояние до которых изменилось.
+    std::vector<int> apply(const std::vector<edge>& insertions, const std::vector<edge>& deletions);
+
+    int distance(int v) const { return dist_[v].load(std::memory_order_relaxed); }
+    std::vector<int> distances() const;
+
+    const std::vector<std::vector<int>>& graph() const { return graph_; }
+    int source() const { return source_; }
+    // Новая версия из new_graph_version() при каждом apply, изменившем граф
+    uint64_t graph_version() const { return version_; }
+
+private:
+    void invalidate(const std::vector<edge>& deletions);
+    void relax(const std::vector<edge>& insertions);
+
+    std::vector<std::vector<int>> graph_;
+    int source_;
+    size_t n_;
+    uint64_t version_;
+
+    arena::array<std::atomic<int>> dist_;
+    arena::array<int> saved_;
+    arena::array<char> touched_;
+    arena::array<char> invalid_;
+    std::vector<int> touched_list_;
+    std::vector<int> invalid_list_;
+
+    frontier::visited_flags queued_;
+    frontier::buffers buf_;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "arena.h"
+#include "frontier.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// BFS по подграфу без копирования: фильтры вершин и рёбер проверяются прямо в
+// цикле по фронту. Фильтры - параметры шаблона, поэтому all_vertices и
+// all_edges по умолчанию не стоят ничего.
+//
+// Фильтр вершин: bool(size_t v). Фильтр рёбер: bool(size_t from, size_t to,
+// size_t j), j - номер ребра в списке смежности from (для csr_graph ребро
+// offsets()[from] + j). Вызываются параллельно, должны быть без гонок.
+
+struct all_vertices {
+    bool operator()(size_t) const { return true; }
+};
+
+struct all_edges {
+    bool operator()(size_t, size_t, size_t) const { return true; }
+};
+
+// Битовая маска вершин, изначально все разрешены
+class vertex_mask {
+public:
+    explicit vertex_mask(size_t n) : bits_((n + 63) / 64, ~uint64_t(0)) {}
+
+    // Не потокобезопасны для вершин одного слова
+    void exclude(size_t v) { bits_[v / 64] &= ~(uint64_t(1) << (v % 64)); }
+    void include(size_t v) { bits_[v / 64] |= uint64_t(1) << (v % 64); }
+
+    bool operator()(size_t v) const { return (bits_[v / 64] >> (v % 64)) & 1; }
+
+private:
+    arena::array<uint64_t> bits_;
+};
+
+// Вершины, запрещённые фильтром, и недостижимые по разрешённым рёбрам - -1.
+// Если запрещён сам start, достижимых нет.
+template <typename Graph, typename VertexFilter = all_vertices, typename EdgeFilter = all_edges>
+std::vector<int> filtered_bfs(const Graph& graph, int start_int,
+                              const VertexFilter& allowed = VertexFilter(),
+                              const EdgeFilter& edge_allowed = EdgeFilter()) {
+    size_t n = graph.size();
+
+    std::vector<int> res(n, -1);
+    size_t start = static_cast<size_t>(start_int);
+
+    if (n == 0 || !allowed(start)) return res;
+
+    int* dist = res.data();
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
+
+    visited.claim(start);
+    dist[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+
+    while (buf.current_size > 0) {
+        frontier::expand(graph, buf,
+            [&visited, &allowed, &edge_allowed, dist] (size_t from, const auto& edge, size_t j) {
+                size_t k = frontier::edge_target(edge);
+                if (!allowed(k) || !edge_allowed(from, k, j)) return false;
+                if (visited.claim(k)) {
+                    dist[k] = dist[from] + 1;
+                    return true;
+                }
+                return false;
+            }
+        );
+    }
+
+    return res;
+}
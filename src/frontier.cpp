@@ -0,0 +1,51 @@
+#include "frontier.h"
+#include <utility>
+
+namespace frontier {
+
+size_t scan(size_t* a, size_t n) {
+    if (n == 0) return 0;
+
+    size_t grain = current_tuning().scan_grain;
+    if (n <= grain) {
+        size_t sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            size_t x = a[i];
+            a[i] = sum;
+            sum += x;
+        }
+        return sum;
+    }
+
+    size_t res = a[n - 1];
+
+    for (size_t i = 1; i < n; i *= 2) {
+        parlay::parallel_for(1, n / (2 * i) + 1,
+            [=] (size_t j) {
+                size_t idx = 2 * i * j - 1;
+                if (idx < n && idx - i < n) {
+                    a[idx] += a[idx - i];
+                }
+            }, static_cast<long>(grain)
+        );
+    }
+
+    a[n - 1] = 0;
+
+    for (size_t i = n; i > 1; i /= 2) {
+        parlay::parallel_for(1, n / i + 1,
+            [=] (size_t j) {
+                size_t x = i * j - (i / 2) - 1;
+                size_t y = i * j - 1;
+                if (x < n && y < n) {
+                    a[x] += a[y];
+                    std::swap(a[x], a[y]);
+                }
+            }, static_cast<long>(grain)
+        );
+    }
+
+    return res + a[n - 1];
+}
+
+}
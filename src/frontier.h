@@ -0,0 +1,184 @@
+#pragma once
+
+#include "arena.h"
+#include "tuning.h"
+#include <parlay/parallel.h>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace frontier {
+
+// Эксклюзивный префиксный сумматор на месте, n должно быть степенью двойки.
+// Возвращает сумму всех элементов.
+size_t scan(size_t* a, size_t n);
+
+inline size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p *= 2;
+    }
+    return p;
+}
+
+class visited_flags {
+public:
+    explicit visited_flags(size_t n)
+        : flags_(static_cast<std::atomic_flag*>(arena::allocate(n * sizeof(std::atomic_flag)))) {
+        std::atomic_flag* flags = flags_;
+        parlay::parallel_for(0, n,
+            [=] (size_t i) {
+                std::atomic_flag* flag = new (flags + i) std::atomic_flag();
+                flag->clear();
+            }
+        );
+    }
+
+    ~visited_flags() { arena::deallocate(flags_); }
+
+    visited_flags(const visited_flags&) = delete;
+    visited_flags& operator=(const visited_flags&) = delete;
+
+    std::atomic_flag* data() const { return flags_; }
+
+    // true, если вершину захватил именно этот вызов
+    bool claim(size_t v) const { return !flags_[v].test_and_set(); }
+
+private:
+    std::atomic_flag* flags_;
+};
+
+// current, next и next_by_node по n элементов, sizes - степень двойки >= n.
+// next_by_node индексируется номером вершины и хранит односвязные списки
+// найденных вершин, sizes после scan даёт смещения этих списков в next.
+class buffers {
+public:
+    explicit buffers(size_t n)
+        : log_size_(round_up_pow2(n)),
+          buff_common_(static_cast<size_t*>(arena::allocate((3 * n + log_size_) * sizeof(size_t)))),
+          current(buff_common_),
+          next(buff_common_ + n),
+          next_by_node(buff_common_ + 2 * n),
+          sizes(buff_common_ + 3 * n) {}
+
+    ~buffers() { arena::deallocate(buff_common_); }
+
+    buffers(const buffers&) = delete;
+    buffers& operator=(const buffers&) = delete;
+
+    size_t sizes_capacity() const { return log_size_; }
+
+private:
+    size_t log_size_;
+    size_t* buff_common_;
+
+public:
+    size_t* current;
+    size_t* next;
+    size_t* next_by_node;
+    size_t* sizes;
+    size_t current_size = 0;
+};
+
+inline size_t edge_target(int v) { return static_cast<size_t>(v); }
+
+template <typename W>
+size_t edge_target(const std::pair<int, W>& e) { return static_cast<size_t>(e.first); }
+
+// Фазы уровня для профилировщика: probe(p) вызывается в начале каждой фазы,
+// probe(phase::done) - после последней. no_probe ничего не стоит.
+enum class phase { init, expand, scan, scatter, done };
+
+struct no_probe {
+    void operator()(phase) const {}
+};
+
+// Один уровень обхода. visit(from, edge) вызывается для каждого ребра фронта
+// (edge - элемент списка смежности; если visit принимает третий аргумент, в
+// нём номер ребра в списке смежности from) и возвращает true, если конец ребра
+// захвачен этим ребром. Каждая вершина должна захватываться не более одного
+// раза за уровень, вершины текущего фронта захватывать нельзя. Новый фронт
+// оказывается в b.current, возвращается его размер.
+template <typename Graph, typename Visit, typename Probe = no_probe>
+size_t expand(const Graph& edges, buffers& b, Visit visit, Probe&& probe = Probe()) {
+    probe(phase::expand);
+
+    size_t* current = b.current;
+    size_t* next = b.next;
+    size_t* next_by_node = b.next_by_node;
+    size_t* sizes = b.sizes;
+    size_t current_size = b.current_size;
+
+    // Малый фронт - одной задачей
+    const bfs_tuning& tuning = current_tuning();
+    bool small = current_size < tuning.sequential_below;
+    long expand_grain = static_cast<long>(small ? current_size : tuning.expand_grain);
+    long scatter_grain = static_cast<long>(small ? current_size : tuning.scatter_grain);
+
+    parlay::parallel_for(0, current_size,
+        [&edges, &visit, next_by_node, sizes, current] (size_t i) {
+            sizes[i] = 0;
+            size_t ind = current[i];
+            size_t curr = ind;
+
+            next_by_node[curr] = curr;
+
+            const auto& next_nodes = edges[ind];
+            for (size_t j = 0; j < next_nodes.size(); j++) {
+                size_t k = edge_target(next_nodes[j]);
+
+                bool claimed;
+                if constexpr (std::is_invocable_v<Visit&, size_t, decltype(next_nodes[j]), size_t>) {
+                    claimed = visit(ind, next_nodes[j], j);
+                } else {
+                    claimed = visit(ind, next_nodes[j]);
+                }
+
+                if (claimed) {
+                    sizes[i]++;
+                    next_by_node[curr] = k;
+                    curr = k;
+                    next_by_node[curr] = curr;
+                }
+            }
+        }, expand_grain
+    );
+
+    probe(phase::scan);
+
+    size_t current_size2 = round_up_pow2(current_size);
+
+    parlay::parallel_for(current_size, current_size2,
+        [=] (size_t i) {
+            sizes[i] = 0;
+        }, static_cast<long>(tuning.scan_grain)
+    );
+
+    size_t k = scan(sizes, current_size2);
+
+    probe(phase::scatter);
+
+    parlay::parallel_for(0, current_size,
+        [=] (size_t i) {
+            size_t s = sizes[i];
+            size_t curr = current[i];
+            size_t j = 0;
+
+            while (next_by_node[curr] != curr) {
+                curr = next_by_node[curr];
+                next[s + j] = curr;
+                j++;
+            }
+        }, scatter_grain
+    );
+
+    std::swap(b.current, b.next);
+    b.current_size = k;
+
+    probe(phase::done);
+    return k;
+}
+
+}
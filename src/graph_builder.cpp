@@ -0,0 +1,97 @@
+#include "graph_builder.h"
+#include "arena.h"
+#include "frontier.h"
+#include <parlay/parallel.h>
+#include <parlay/primitives.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr size_t block_size = size_t(1) << 16;
+
+inline uint64_t pack(int u, int v) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(u)) << 32) | static_cast<uint32_t>(v);
+}
+
+inline size_t source(uint64_t key) { return static_cast<size_t>(key >> 32); }
+inline int target(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key)); }
+
+// Ребро остаётся, если это не петля и не повтор предыдущего в порядке сортировки
+inline bool keep(const uint64_t* keys, size_t i) {
+    return source(keys[i]) != static_cast<size_t>(target(keys[i])) && (i == 0 || keys[i - 1] != keys[i]);
+}
+
+}
+
+csr_graph build_graph(size_t n, const std::pair<int, int>* edges, size_t m, bool symmetrize) {
+    size_t count = symmetrize ? 2 * m : m;
+    arena::array<uint64_t> keys_holder(count);
+    uint64_t* keys = keys_holder.data();
+
+    parlay::parallel_for(0, m,
+        [=] (size_t i) {
+            keys[i] = pack(edges[i].first, edges[i].second);
+            if (symmetrize) keys[m + i] = pack(edges[i].second, edges[i].first);
+        }
+    );
+    parlay::sort_inplace(parlay::make_slice(keys, keys + count));
+
+    // Сжатие по блокам: сколько рёбер остаётся в каждом блоке, затем scan даёт
+    // место блока в targets
+    size_t blocks = (count + block_size - 1) / block_size;
+    std::vector<size_t> kept(frontier::round_up_pow2(blocks), 0);
+    size_t* kept_data = kept.data();
+    parlay::parallel_for(0, blocks,
+        [=] (size_t b) {
+            size_t end = std::min(count, (b + 1) * block_size);
+            size_t c = 0;
+            for (size_t i = b * block_size; i < end; i++) {
+                c += keep(keys, i);
+            }
+            kept_data[b] = c;
+        },
+        1
+    );
+    size_t total = frontier::scan(kept_data, kept.size());
+
+    arena::array<uint64_t> offsets_holder(n + 1);
+    arena::array<int> targets_holder(total);
+    uint64_t* offsets = offsets_holder.data();
+    int* targets = targets_holder.data();
+
+    // offsets[u] - число оставшихся рёбер до первого ребра из u. Его пишет блок,
+    // где начинаются рёбра u, заодно для вершин без рёбер между ней и предыдущей
+    parlay::parallel_for(0, blocks,
+        [=] (size_t b) {
+            size_t end = std::min(count, (b + 1) * block_size);
+            size_t pos = kept_data[b];
+            for (size_t i = b * block_size; i < end; i++) {
+                size_t u = source(keys[i]);
+                if (i == 0 || source(keys[i - 1]) != u) {
+                    size_t first = i == 0 ? 0 : source(keys[i - 1]) + 1;
+                    for (size_t w = first; w <= u; w++) {
+                        offsets[w] = pos;
+                    }
+                }
+                if (keep(keys, i)) {
+                    targets[pos++] = target(keys[i]);
+                }
+            }
+        },
+        1
+    );
+
+    size_t last = count == 0 ? 0 : source(keys[count - 1]) + 1;
+    parlay::parallel_for(last, n + 1,
+        [=] (size_t w) {
+            offsets[w] = total;
+        }
+    );
+
+    return csr_graph(std::move(offsets_holder), std::move(targets_holder));
+}
+
+csr_graph build_graph(size_t n, const std::vector<std::pair<int, int>>& edges, bool symmetrize) {
+    return build_graph(n, edges.data(), edges.size(), symmetrize);
+}
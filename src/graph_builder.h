@@ -0,0 +1,12 @@
+#pragma once
+
+#include "csr_graph.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Собирает CSR-граф на n вершинах из массива рёбер (u, v), 0 <= u, v < n.
+// При symmetrize каждое ребро добавляется в обе стороны. Петли и повторные
+// рёбра удаляются, списки смежности упорядочены по возрастанию.
+csr_graph build_graph(size_t n, const std::pair<int, int>* edges, size_t m, bool symmetrize = true);
+csr_graph build_graph(size_t n, const std::vector<std::pair<int, int>>& edges, bool symmetrize = true);
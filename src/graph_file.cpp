@@ -0,0 +1,75 @@
+#include "graph_file.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+const char magic[8] = {'P', 'B', 'F', 'S', 'G', 'R', 'F', '1'};
+
+std::ifstream open_for_read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot open graph file " + path);
+    return in;
+}
+
+void read_exact(std::ifstream& in, void* data, size_t bytes, const std::string& path) {
+    in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+    if (!in) throw std::runtime_error("truncated graph file " + path);
+}
+}
+
+void write_graph_file(const std::string& path, const std::vector<std::vector<int>>& graph) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot create graph file " + path);
+
+    uint64_t n = graph.size();
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (uint64_t v = 0; v < n; v++) {
+        offsets[v + 1] = offsets[v] + graph[v].size();
+    }
+    uint64_t m = offsets[n];
+
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.write(reinterpret_cast<const char*>(&m), sizeof(m));
+    out.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+    for (const auto& list : graph) {
+        out.write(reinterpret_cast<const char*>(list.data()), static_cast<std::streamsize>(list.size() * sizeof(int)));
+    }
+
+    if (!out) throw std::runtime_error("failed to write graph file " + path);
+}
+
+graph_file_header read_graph_header(const std::string& path) {
+    std::ifstream in = open_for_read(path);
+    char buf[8];
+    read_exact(in, buf, sizeof(buf), path);
+    if (std::memcmp(buf, magic, sizeof(magic)) != 0) throw std::runtime_error("not a graph file: " + path);
+
+    graph_file_header header;
+    read_exact(in, &header.n, sizeof(header.n), path);
+    read_exact(in, &header.m, sizeof(header.m), path);
+    return header;
+}
+
+std::vector<uint64_t> read_graph_offsets(const std::string& path, const graph_file_header& header) {
+    std::ifstream in = open_for_read(path);
+    in.seekg(static_cast<std::streamoff>(header.offsets_position()));
+    std::vector<uint64_t> offsets(header.n + 1);
+    read_exact(in, offsets.data(), offsets.size() * sizeof(uint64_t), path);
+    return offsets;
+}
+
+std::vector<std::vector<int>> read_graph_file(const std::string& path) {
+    graph_file_header header = read_graph_header(path);
+    std::vector<uint64_t> offsets = read_graph_offsets(path, header);
+
+    std::ifstream in = open_for_read(path);
+    in.seekg(static_cast<std::streamoff>(header.targets_position()));
+    std::vector<std::vector<int>> graph(header.n);
+    for (uint64_t v = 0; v < header.n; v++) {
+        graph[v].resize(offsets[v + 1] - offsets[v]);
+        read_exact(in, graph[v].data(), graph[v].size() * sizeof(int), path);
+    }
+    return graph;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Двоичный формат графа на диске (little-endian):
+//   8 байт   "PBFSGRF1"
+//   uint64   n, m
+//   uint64   offsets[n + 1]  - начало списка смежности вершины в targets
+//   int32    targets[m]
+struct graph_file_header {
+    uint64_t n = 0;
+    uint64_t m = 0;
+
+    uint64_t offsets_position() const { return 24; }
+    uint64_t targets_position() const { return 24 + (n + 1) * sizeof(uint64_t); }
+};
+
+// Ошибки ввода-вывода и неверный формат - std::runtime_error
+void write_graph_file(const std::string& path, const std::vector<std::vector<int>>& graph);
+std::vector<std::vector<int>> read_graph_file(const std::string& path);
+
+graph_file_header read_graph_header(const std::string& path);
+std::vector<uint64_t> read_graph_offsets(const std::string& path, const graph_file_header& header);
@@ -0,0 +1,7 @@
+#include "graph_version.h"
+#include <atomic>
+
+uint64_t new_graph_version() {
+    static std::atomic<uint64_t> counter(0);
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
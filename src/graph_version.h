@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Версия графа для кэша результатов (bfs_cache). Уникальна в процессе, так что
+// по ней различаются и разные графы, и состояния одного графа. Статическому
+// графу достаточно одной версии на всё время жизни, изменяемый берёт новую
+// после каждого изменения (dynamic_bfs::graph_version()). 0 не выдаётся.
+uint64_t new_graph_version();
@@ -0,0 +1,211 @@
+#include "grid_bfs.h"
+#include "arena.h"
+#include <parlay/parallel.h>
+#include <atomic>
+#include <cstdint>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Строка - padded слов с данными и по нулевому слову слева и справа, чтобы
+// переносы битов между словами читались без проверок границ
+constexpr size_t simd_words = 8;
+
+inline unsigned lowest_bit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+struct row_sources {
+    const uint64_t* current;
+    const uint64_t* y_prev;
+    const uint64_t* y_next;
+    const uint64_t* z_prev;
+    const uint64_t* z_next;
+};
+
+// Новый фронт строки: соседи по x сдвигами current, по y и z - строки целиком,
+// без посещённых. Возвращает OR всех слов результата.
+uint64_t advance_row(const row_sources& s, uint64_t* visited, uint64_t* out, size_t padded) {
+    size_t i = 0;
+    uint64_t any = 0;
+
+#if defined(__AVX512F__)
+    __m512i acc = _mm512_setzero_si512();
+    for (; i < padded; i += 8) {
+        __m512i w = _mm512_loadu_si512(s.current + i);
+        __m512i left = _mm512_loadu_si512(s.current + i - 1);
+        __m512i right = _mm512_loadu_si512(s.current + i + 1);
+        __m512i d = _mm512_or_si512(w, _mm512_or_si512(_mm512_slli_epi64(w, 1), _mm512_srli_epi64(left, 63)));
+        d = _mm512_or_si512(d, _mm512_or_si512(_mm512_srli_epi64(w, 1), _mm512_slli_epi64(right, 63)));
+        d = _mm512_or_si512(d, _mm512_or_si512(_mm512_loadu_si512(s.y_prev + i), _mm512_loadu_si512(s.y_next + i)));
+        d = _mm512_or_si512(d, _mm512_or_si512(_mm512_loadu_si512(s.z_prev + i), _mm512_loadu_si512(s.z_next + i)));
+        __m512i v = _mm512_loadu_si512(visited + i);
+        __m512i fresh = _mm512_andnot_si512(v, d);
+        _mm512_storeu_si512(out + i, fresh);
+        _mm512_storeu_si512(visited + i, _mm512_or_si512(v, fresh));
+        acc = _mm512_or_si512(acc, fresh);
+    }
+    any = _mm512_test_epi64_mask(acc, acc) != 0;
+#elif defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i < padded; i += 4) {
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.current + i));
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.current + i - 1));
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.current + i + 1));
+        __m256i d = _mm256_or_si256(w, _mm256_or_si256(_mm256_slli_epi64(w, 1), _mm256_srli_epi64(left, 63)));
+        d = _mm256_or_si256(d, _mm256_or_si256(_mm256_srli_epi64(w, 1), _mm256_slli_epi64(right, 63)));
+        d = _mm256_or_si256(d, _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.y_prev + i)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.y_next + i))));
+        d = _mm256_or_si256(d, _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.z_prev + i)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.z_next + i))));
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(visited + i));
+        __m256i fresh = _mm256_andnot_si256(v, d);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), fresh);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(visited + i), _mm256_or_si256(v, fresh));
+        acc = _mm256_or_si256(acc, fresh);
+    }
+    any = !_mm256_testz_si256(acc, acc);
+#endif
+
+    for (; i < padded; i++) {
+        uint64_t w = s.current[i];
+        uint64_t d = w | (w << 1) | (s.current[i - 1] >> 63) | (w >> 1) | (s.current[i + 1] << 63)
+                   | s.y_prev[i] | s.y_next[i] | s.z_prev[i] | s.z_next[i];
+        uint64_t fresh = d & ~visited[i];
+        out[i] = fresh;
+        visited[i] |= fresh;
+        any |= fresh;
+    }
+    return any;
+}
+
+}
+
+const char* grid_bfs_kernel() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+std::vector<int> grid_bfs(int size_x, int size_y, int size_z, int start) {
+    if (size_x <= 0 || size_y <= 0 || size_z <= 0) return {};
+
+    size_t sx = static_cast<size_t>(size_x);
+    size_t sy = static_cast<size_t>(size_y);
+    size_t sz = static_cast<size_t>(size_z);
+    size_t n = sx * sy * sz;
+    size_t rows = sy * sz;
+
+    std::vector<int> res(n, -1);
+    int* dist = res.data();
+
+    size_t words = (sx + 63) / 64;
+    size_t padded = (words + simd_words - 1) / simd_words * simd_words;
+    size_t stride = padded + 2;
+
+    // Строка rows - нулевая, её подставляют вместо соседей за границей решётки
+    arena::array<uint64_t> planes_holder(3 * (rows + 1) * stride, 0);
+    uint64_t* frontier_plane[2] = {planes_holder.data(), planes_holder.data() + (rows + 1) * stride};
+    uint64_t* visited = planes_holder.data() + 2 * (rows + 1) * stride;
+
+    // Биты за концом строки считаются посещёнными и в фронт не попадают
+    parlay::parallel_for(0, rows,
+        [=] (size_t r) {
+            uint64_t* row = visited + r * stride + 1;
+            for (size_t x = sx; x < padded * 64; x++) {
+                row[x / 64] |= uint64_t(1) << (x % 64);
+            }
+        }
+    );
+
+    // Непустые строки фронта в каждом из двух буферов
+    arena::array<char> active_holder(2 * rows, 0);
+    char* active[2] = {active_holder.data(), active_holder.data() + rows};
+
+    size_t s = static_cast<size_t>(start);
+    size_t start_row = s / sx;
+    frontier_plane[0][start_row * stride + 1 + (s % sx) / 64] |= uint64_t(1) << (s % sx % 64);
+    visited[start_row * stride + 1 + (s % sx) / 64] |= uint64_t(1) << (s % sx % 64);
+    active[0][start_row] = 1;
+    dist[s] = 0;
+
+    int level = 0;
+    int cur = 0;
+    std::atomic<bool> more(true);
+    while (more.load()) {
+        more.store(false);
+        level++;
+
+        const uint64_t* current = frontier_plane[cur];
+        uint64_t* next = frontier_plane[1 - cur];
+        const char* current_active = active[cur];
+        char* next_active = active[1 - cur];
+
+        parlay::parallel_for(0, rows,
+            [=, &more] (size_t r) {
+                size_t y = r % sy;
+                bool y_prev = y > 0;
+                bool y_next = y + 1 < sy;
+                bool z_prev = r >= sy;
+                bool z_next = r + sy < rows;
+
+                bool touched = current_active[r]
+                    || (y_prev && current_active[r - 1]) || (y_next && current_active[r + 1])
+                    || (z_prev && current_active[r - sy]) || (z_next && current_active[r + sy]);
+
+                uint64_t* out = next + r * stride + 1;
+                if (!touched) {
+                    // Строка могла остаться непустой с позапрошлого уровня
+                    if (next_active[r]) {
+                        for (size_t i = 0; i < padded; i++) out[i] = 0;
+                        next_active[r] = 0;
+                    }
+                    return;
+                }
+
+                const uint64_t* zero = current + rows * stride + 1;
+                row_sources src = {
+                    current + r * stride + 1,
+                    y_prev ? current + (r - 1) * stride + 1 : zero,
+                    y_next ? current + (r + 1) * stride + 1 : zero,
+                    z_prev ? current + (r - sy) * stride + 1 : zero,
+                    z_next ? current + (r + sy) * stride + 1 : zero
+                };
+                bool any = advance_row(src, visited + r * stride + 1, out, padded) != 0;
+                next_active[r] = any;
+                if (!any) return;
+
+                more.store(true, std::memory_order_relaxed);
+                int* row_dist = dist + r * sx;
+                for (size_t i = 0; i < words; i++) {
+                    uint64_t bits = out[i];
+                    while (bits) {
+                        row_dist[i * 64 + lowest_bit(bits)] = level;
+                        bits &= bits - 1;
+                    }
+                }
+            }
+        );
+
+        cur = 1 - cur;
+    }
+
+    return res;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+// BFS по решётке size_x x size_y x size_z с 6-соседством, вершины нумеруются
+// как в create_cube_grid: x + y * size_x + z * size_x * size_y. Фронт и
+// посещённые хранятся битовыми строками вдоль x, уровень - расширение фронта
+// сдвигами и OR по целым строкам с маской непосещённых.
+std::vector<int> grid_bfs(int size_x, int size_y, int size_z, int start);
+
+// Ядро, с которым собран grid_bfs: "avx512", "avx2" или "scalar"
+const char* grid_bfs_kernel();
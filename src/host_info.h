@@ -0,0 +1,6 @@
+#pragma once
+
+#include <string>
+
+// Имя машины; "unknown", если его не удалось получить
+std::string host_name();
@@ -0,0 +1,60 @@
+#include "khop.h"
+#include <algorithm>
+
+khop_bfs::khop_bfs(const std::vector<std::vector<int>>& graph)
+    : graph_(graph),
+      stamp_(graph.size()),
+      buf_(graph.size()) {
+    std::atomic<uint32_t>* stamp = stamp_.get();
+    parlay::parallel_for(0, graph.size(),
+        [=] (size_t i) {
+            stamp[i].store(0, std::memory_order_relaxed);
+        }
+    );
+}
+
+reached_list khop_bfs::query(int start, int max_depth, size_t max_reached) {
+    reached_list out;
+    if (max_reached == 0 || max_depth < 0) return out;
+
+    std::atomic<uint32_t>* stamp = stamp_.get();
+
+    // Переполнение эпохи - единственный случай полного сброса
+    if (epoch_ == UINT32_MAX) {
+        parlay::parallel_for(0, graph_.size(),
+            [=] (size_t i) {
+                stamp[i].store(0, std::memory_order_relaxed);
+            }
+        );
+        epoch_ = 0;
+    }
+    uint32_t epoch = ++epoch_;
+
+    stamp[start].store(epoch, std::memory_order_relaxed);
+    out.emplace_back(start, 0);
+    buf_.current[0] = static_cast<size_t>(start);
+    buf_.current_size = 1;
+
+    for (int level = 1; level <= max_depth && buf_.current_size > 0 && out.size() < max_reached; level++) {
+        frontier::expand(graph_, buf_,
+            [stamp, epoch] (size_t, size_t k) {
+                uint32_t cur = stamp[k].load(std::memory_order_relaxed);
+                return cur != epoch && stamp[k].compare_exchange_strong(cur, epoch);
+            }
+        );
+
+        size_t take = std::min(buf_.current_size, max_reached - out.size());
+        size_t offset = out.size();
+        out.resize(offset + take);
+
+        size_t* current = buf_.current;
+        std::pair<int, int>* dst = out.data() + offset;
+        parlay::parallel_for(0, take,
+            [=] (size_t i) {
+                dst[i] = {static_cast<int>(current[i]), level};
+            }
+        );
+    }
+
+    return out;
+}
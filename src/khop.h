@@ -0,0 +1,30 @@
+#pragma once
+
+#include "arena.h"
+#include "frontier.h"
+#include "parbfs.h"
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+// Обход на глубину не больше k с разреженным ответом. Состояние размера n
+// заводится один раз при создании, между запросами ничего не сбрасывается:
+// посещённость хранится метками эпохи, поэтому стоимость запроса зависит
+// только от числа найденных вершин и их рёбер. Один объект - один запрос
+// одновременно. Граф не копируется и должен жить дольше объекта, временный
+// граф не принимается.
+class khop_bfs {
+public:
+    explicit khop_bfs(const std::vector<std::vector<int>>& graph);
+    explicit khop_bfs(std::vector<std::vector<int>>&&) = delete;
+
+    // Вершины на расстоянии не больше max_depth. Обход прекращается, как только
+    // найдено max_reached вершин, с последнего уровня берётся префикс.
+    reached_list query(int start, int max_depth, size_t max_reached = SIZE_MAX);
+
+private:
+    const std::vector<std::vector<int>>& graph_;
+    arena::array<std::atomic<uint32_t>> stamp_;
+    uint32_t epoch_ = 0;
+    frontier::buffers buf_;
+};
@@ -0,0 +1,246 @@
+#include "landmarks.h"
+#include "arena.h"
+#include "csr_graph.h"
+#include <parlay/parallel.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+const char magic[8] = {'P', 'B', 'F', 'S', 'P', 'L', 'L', '1'};
+
+// Рабочие массивы потока размера n, между обходами сбрасываются только
+// затронутые элементы
+struct workspace {
+    explicit workspace(size_t n) : dist(n, -1), root_label(n, -1) {}
+
+    arena::array<int> dist;
+    // Расстояние от текущего корня до хаба по его меткам, индекс - ранг хаба
+    arena::array<int> root_label;
+    std::vector<int> queue;
+};
+
+// Новые метки одного корня: (вершина, расстояние)
+using root_labels = std::vector<std::pair<int, int>>;
+
+template <typename Graph>
+size_t pruned_bfs(const Graph& graph, int root, int root_rank, const std::vector<int>& rank,
+                  const std::vector<std::vector<label_entry>>& labels, workspace& ws, root_labels& out) {
+    for (const label_entry& e : labels[root]) {
+        ws.root_label[e.hub] = e.dist;
+    }
+
+    size_t pruned = 0;
+    std::vector<int>& queue = ws.queue;
+    queue.clear();
+    queue.push_back(root);
+    ws.dist[root] = 0;
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        int u = queue[head];
+        int d = ws.dist[u];
+
+        // Хабы старше корня уже покрывают пару (root, u)
+        bool covered = false;
+        for (const label_entry& e : labels[u]) {
+            int via = ws.root_label[e.hub];
+            if (via >= 0 && via + e.dist <= d) {
+                covered = true;
+                break;
+            }
+        }
+        if (covered) {
+            pruned++;
+            continue;
+        }
+
+        out.emplace_back(u, d);
+        const auto& next = graph[u];
+        for (size_t j = 0; j < next.size(); j++) {
+            int k = next[j];
+            // Вершины старше корня обойдены раньше и покрывают всё за собой
+            if (ws.dist[k] == -1 && rank[k] > root_rank) {
+                ws.dist[k] = d + 1;
+                queue.push_back(k);
+            }
+        }
+    }
+
+    for (int v : queue) ws.dist[v] = -1;
+    for (const label_entry& e : labels[root]) {
+        ws.root_label[e.hub] = -1;
+    }
+    return pruned;
+}
+
+template <typename Graph>
+void build_index(const Graph& graph, size_t max_batch, landmark_build_stats* stats,
+                 std::vector<int>& rank_out, std::vector<uint64_t>& offsets_out,
+                 std::vector<label_entry>& labels_out) {
+    auto build_start = std::chrono::steady_clock::now();
+    size_t n = graph.size();
+    if (max_batch == 0) max_batch = 4 * parlay::num_workers();
+
+    // Порядок: по убыванию степени, при равенстве по номеру
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+        [&graph] (int a, int b) {
+            size_t da = graph[a].size();
+            size_t db = graph[b].size();
+            return da != db ? da > db : a < b;
+        }
+    );
+    std::vector<int> rank(n);
+    for (size_t i = 0; i < n; i++) {
+        rank[order[i]] = static_cast<int>(i);
+    }
+
+    std::vector<std::vector<label_entry>> labels(n);
+    std::vector<std::unique_ptr<workspace>> workspaces(parlay::num_workers());
+    std::vector<root_labels> found;
+    std::vector<size_t> pruned;
+    size_t batches = 0;
+    size_t total_pruned = 0;
+
+    size_t batch = 1;
+    for (size_t first = 0; first < n; first += batch, batch = std::min(2 * batch, max_batch)) {
+        size_t count = std::min(batch, n - first);
+        found.assign(count, root_labels());
+        pruned.assign(count, 0);
+
+        parlay::parallel_for(0, count,
+            [&] (size_t i) {
+                std::unique_ptr<workspace>& ws = workspaces[parlay::worker_id()];
+                if (!ws) ws = std::make_unique<workspace>(n);
+                int root_rank = static_cast<int>(first + i);
+                pruned[i] = pruned_bfs(graph, order[root_rank], root_rank, rank, labels, *ws, found[i]);
+            }, 1
+        );
+
+        // Корни пачки идут по возрастанию ранга, списки остаются упорядоченными
+        for (size_t i = 0; i < count; i++) {
+            int hub = static_cast<int>(first + i);
+            for (const auto& [v, d] : found[i]) {
+                labels[v].push_back(label_entry{hub, d});
+            }
+            total_pruned += pruned[i];
+        }
+        batches++;
+    }
+
+    offsets_out.assign(n + 1, 0);
+    for (size_t v = 0; v < n; v++) {
+        offsets_out[v + 1] = offsets_out[v] + labels[v].size();
+    }
+    labels_out.resize(offsets_out[n]);
+    label_entry* flat = labels_out.data();
+    const uint64_t* offsets = offsets_out.data();
+    parlay::parallel_for(0, n,
+        [&labels, flat, offsets] (size_t v) {
+            std::copy(labels[v].begin(), labels[v].end(), flat + offsets[v]);
+        }
+    );
+    rank_out = std::move(rank);
+
+    if (stats) {
+        stats->batches = batches;
+        stats->labels = labels_out.size();
+        stats->pruned = total_pruned;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_start).count();
+    }
+}
+
+void read_exact(std::ifstream& in, void* data, size_t bytes, const std::string& path) {
+    in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+    if (!in) throw std::runtime_error("truncated landmark index " + path);
+}
+}
+
+landmark_index::landmark_index(std::vector<int> rank, std::vector<uint64_t> offsets, std::vector<label_entry> labels)
+    : rank_(std::move(rank)), offsets_(std::move(offsets)), labels_(std::move(labels)) {}
+
+landmark_index::landmark_index(const std::vector<std::vector<int>>& graph, size_t max_batch,
+                               landmark_build_stats* stats) {
+    build_index(graph, max_batch, stats, rank_, offsets_, labels_);
+}
+
+landmark_index::landmark_index(const csr_graph& graph, size_t max_batch, landmark_build_stats* stats) {
+    build_index(graph, max_batch, stats, rank_, offsets_, labels_);
+}
+
+int landmark_index::distance(int u, int v) const {
+    if (u == v) return 0;
+
+    const label_entry* a = labels_.data() + offsets_[u];
+    const label_entry* a_end = labels_.data() + offsets_[u + 1];
+    const label_entry* b = labels_.data() + offsets_[v];
+    const label_entry* b_end = labels_.data() + offsets_[v + 1];
+
+    int best = -1;
+    while (a != a_end && b != b_end) {
+        if (a->hub < b->hub) {
+            a++;
+        } else if (a->hub > b->hub) {
+            b++;
+        } else {
+            int d = a->dist + b->dist;
+            if (best < 0 || d < best) best = d;
+            a++;
+            b++;
+        }
+    }
+    return best;
+}
+
+size_t landmark_index::bytes() const {
+    return rank_.size() * sizeof(int) + offsets_.size() * sizeof(uint64_t) + labels_.size() * sizeof(label_entry);
+}
+
+void write_landmark_index(const std::string& path, const landmark_index& index) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot create landmark index " + path);
+
+    uint64_t n = index.size();
+    uint64_t m = index.num_labels();
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.write(reinterpret_cast<const char*>(&m), sizeof(m));
+    out.write(reinterpret_cast<const char*>(index.rank().data()), static_cast<std::streamsize>(n * sizeof(int)));
+    out.write(reinterpret_cast<const char*>(index.offsets().data()),
+              static_cast<std::streamsize>(index.offsets().size() * sizeof(uint64_t)));
+    out.write(reinterpret_cast<const char*>(index.labels().data()), static_cast<std::streamsize>(m * sizeof(label_entry)));
+
+    if (!out) throw std::runtime_error("failed to write landmark index " + path);
+}
+
+landmark_index read_landmark_index(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot open landmark index " + path);
+
+    char buf[8];
+    read_exact(in, buf, sizeof(buf), path);
+    if (std::memcmp(buf, magic, sizeof(magic)) != 0) throw std::runtime_error("not a landmark index: " + path);
+
+    uint64_t n = 0;
+    uint64_t m = 0;
+    read_exact(in, &n, sizeof(n), path);
+    read_exact(in, &m, sizeof(m), path);
+
+    std::vector<int> rank(n);
+    std::vector<uint64_t> offsets(n + 1);
+    std::vector<label_entry> labels(m);
+    read_exact(in, rank.data(), n * sizeof(int), path);
+    read_exact(in, offsets.data(), offsets.size() * sizeof(uint64_t), path);
+    read_exact(in, labels.data(), m * sizeof(label_entry), path);
+
+    if (offsets[0] != 0 || offsets[n] != m) throw std::runtime_error("corrupt landmark index " + path);
+    for (uint64_t v = 0; v < n; v++) {
+        if (offsets[v] > offsets[v + 1]) throw std::runtime_error("corrupt landmark index " + path);
+    }
+    return landmark_index(std::move(rank), std::move(offsets), std::move(labels));
+}
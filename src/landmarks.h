@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class csr_graph;
+
+struct label_entry {
+    // Ранг хаба: место вершины в порядке убывания степени
+    int hub;
+    int dist;
+};
+
+struct landmark_build_stats {
+    size_t batches = 0;
+    size_t labels = 0;
+    // Вершин, где обход из хаба остановлен отсечением
+    size_t pruned = 0;
+    double seconds = 0;
+};
+
+// 2-hop метки для точечных запросов расстояния в неориентированном графе
+// (pruned landmark labeling). Обходы идут из вершин в порядке убывания
+// степени; обход из r не продолжается из u, если уже имеющиеся метки дают
+// d(r, u). Корни пачки обходятся параллельно и отсекаются только метками
+// предыдущих пачек, поэтому меток может быть чуть больше, чем при
+// последовательном построении, но ответы точные. Пачки растут от 1 до
+// max_batch (0 - четыре на поток).
+class landmark_index {
+public:
+    landmark_index() = default;
+    landmark_index(std::vector<int> rank, std::vector<uint64_t> offsets, std::vector<label_entry> labels);
+
+    explicit landmark_index(const std::vector<std::vector<int>>& graph, size_t max_batch = 0,
+                            landmark_build_stats* stats = nullptr);
+    explicit landmark_index(const csr_graph& graph, size_t max_batch = 0,
+                            landmark_build_stats* stats = nullptr);
+
+    // -1, если вершины в разных компонентах
+    int distance(int u, int v) const;
+
+    size_t size() const { return rank_.size(); }
+    size_t num_labels() const { return labels_.size(); }
+    size_t bytes() const;
+
+    const std::vector<int>& rank() const { return rank_; }
+    const std::vector<uint64_t>& offsets() const { return offsets_; }
+    const std::vector<label_entry>& labels() const { return labels_; }
+
+private:
+    std::vector<int> rank_;
+    // Метки вершины v - labels_[offsets_[v]..offsets_[v + 1]), по возрастанию hub
+    std::vector<uint64_t> offsets_;
+    std::vector<label_entry> labels_;
+};
+
+// Двоичный формат (little-endian):
+//   8 байт   "PBFSPLL1"
+//   uint64   n, число меток
+//   int32    rank[n]
+//   uint64   offsets[n + 1]
+//   int32    (hub, dist) меток
+// Ошибки ввода-вывода и неверный формат - std::runtime_error
+void write_landmark_index(const std::string& path, const landmark_index& index);
+landmark_index read_landmark_index(const std::string& path);
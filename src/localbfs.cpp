@@ -0,0 +1,97 @@
+#include "localbfs.h"
+#include "csr_graph.h"
+#include "frontier.h"
+#include <parlay/parallel.h>
+#include <utility>
+
+namespace {
+
+constexpr size_t chunk_size = 256;
+
+// Чанки одного потока на одном уровне. Память чанков переиспользуется между
+// уровнями, used - сколько из них занято сейчас
+struct alignas(64) worker_frontier {
+    std::vector<std::vector<int>> chunks;
+    size_t used = 0;
+
+    void clear() { used = 0; }
+
+    void push(int v) {
+        if (used == 0 || chunks[used - 1].size() == chunk_size) {
+            if (used == chunks.size()) {
+                chunks.emplace_back();
+                chunks.back().reserve(chunk_size);
+            } else {
+                chunks[used].clear();
+            }
+            used++;
+        }
+        chunks[used - 1].push_back(v);
+    }
+};
+
+template <typename Graph>
+std::vector<int> local_frontier_bfs_impl(const Graph& graph, int start) {
+    size_t n = graph.size();
+
+    std::vector<int> res(n, -1);
+    if (n == 0) return res;
+
+    int* dist = res.data();
+    frontier::visited_flags visited(n);
+
+    size_t workers = parlay::num_workers();
+    std::vector<worker_frontier> levels[2] = {std::vector<worker_frontier>(workers),
+                                              std::vector<worker_frontier>(workers)};
+
+    visited.claim(start);
+    dist[start] = 0;
+    levels[0][0].push(start);
+
+    int cur = 0;
+    bool more = true;
+    while (more) {
+        std::vector<worker_frontier>& current = levels[cur];
+        std::vector<worker_frontier>& next = levels[1 - cur];
+        for (auto& w : next) w.clear();
+
+        parlay::parallel_for(0, workers,
+            [&] (size_t owner) {
+                const worker_frontier& source = current[owner];
+                parlay::parallel_for(0, source.used,
+                    [&] (size_t c) {
+                        worker_frontier& out = next[parlay::worker_id()];
+                        for (int v : source.chunks[c]) {
+                            const auto& adj = graph[v];
+                            for (size_t j = 0; j < adj.size(); j++) {
+                                int k = adj[j];
+                                if (visited.claim(k)) {
+                                    dist[k] = dist[v] + 1;
+                                    out.push(k);
+                                }
+                            }
+                        }
+                    },
+                    1
+                );
+            },
+            1
+        );
+
+        more = false;
+        for (const auto& w : next) more = more || w.used > 0;
+        cur = 1 - cur;
+    }
+
+    return res;
+}
+
+}
+
+std::vector<int> local_frontier_bfs(const std::vector<std::vector<int>>& graph, int start) {
+    return local_frontier_bfs_impl(graph, start);
+}
+
+std::vector<int> local_frontier_bfs(const csr_graph& graph, int start) {
+    return local_frontier_bfs_impl(graph, start);
+}
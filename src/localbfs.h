@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+class csr_graph;
+
+// BFS без общего сжатия фронта: каждый поток складывает найденные вершины в
+// свои чанки, следующий уровень обрабатывается вложенным parallel_for по
+// потокам и их чанкам (балансировка - кража задач планировщика parlay).
+// Накладные расходы уровня - O(потоков) вместо scan по фронту.
+std::vector<int> local_frontier_bfs(const std::vector<std::vector<int>>& graph, int start);
+std::vector<int> local_frontier_bfs(const csr_graph& graph, int start);
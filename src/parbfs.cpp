@@ -1,139 +1,144 @@
 #include "parbfs.h"
-#include <parlay/parallel.h>
-#include <parlay/alloc.h>
-#include <numeric>
-#include <atomic>
-#include <memory>
+#include "csr_graph.h"
+#include "frontier.h"
 
 namespace {
-size_t scan(size_t* a, size_t n) {
-    if (n == 0) return 0;
 
-    size_t res = a[n - 1];
+struct alignas(64) edge_counter {
+    size_t value = 0;
+};
 
-    for (size_t i = 1; i < n; i *= 2) {
-        parlay::parallel_for(1, n / (2 * i) + 1,
-            [=] (size_t j) {
-                size_t idx = 2 * i * j - 1;
-                if (idx < n && idx - i < n) {
-                    a[idx] += a[idx - i];
-                }
-            }
-        );
+bfs_status check_stop(const bfs_options& options) {
+    if (options.cancel && options.cancel->load(std::memory_order_relaxed)) return bfs_status::cancelled;
+    if (options.deadline != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= options.deadline) {
+        return bfs_status::deadline_exceeded;
     }
+    return bfs_status::complete;
+}
+
+template <typename Graph>
+std::vector<int> bfs_impl(const Graph& edges, int start_int) {
+    size_t n = edges.size();
+
+    std::vector<int> res(n, -1);
+    size_t start = static_cast<size_t>(start_int);
+
+    if (n == 0) return res;
 
-    a[n - 1] = 0;
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
 
-    for (size_t i = n; i > 1; i /= 2) {
-        parlay::parallel_for(1, n / i + 1,
-            [=] (size_t j) {
-                size_t x = i * j - (i / 2) - 1;
-                size_t y = i * j - 1;
-                if (x < n && y < n) {
-                    a[x] += a[y];
-                    std::swap(a[x], a[y]);
+    visited.claim(start);
+    res[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+
+    while (buf.current_size > 0) {
+        frontier::expand(edges, buf,
+            [&visited, &res] (size_t from, size_t k) {
+                if (visited.claim(k)) {
+                    res[k] = res[from] + 1;
+                    return true;
                 }
+                return false;
             }
         );
     }
 
-    return res + a[n - 1];
-}
+    return res;
 }
 
-std::vector<int> parallel_bfs(const std::vector<std::vector<int>>& edges, int start_int) {
+template <typename Graph>
+bfs_result bfs_impl(const Graph& edges, int start_int, const bfs_options& options) {
     size_t n = edges.size();
 
-    std::vector<int> res(n, -1);
-    size_t start = static_cast<size_t>(start_int);
-
-    if (n == 0) return res;
+    bfs_result result;
+    result.distance.assign(n, -1);
+    if (n == 0) return result;
 
-    std::atomic_flag* visited = static_cast<std::atomic_flag*>(parlay::p_malloc(n * sizeof(std::atomic_flag)));
+    int* dist = result.distance.data();
+    size_t start = static_cast<size_t>(start_int);
 
-    parlay::parallel_for(0, n,
-        [=] (size_t i) {
-            std::atomic_flag* flag = new (visited + i) std::atomic_flag();
-            flag->clear();
+    frontier::visited_flags visited(n);
+    frontier::buffers buf(n);
+
+    visited.claim(start);
+    dist[start] = 0;
+    buf.current[0] = start;
+    buf.current_size = 1;
+
+    // Внутри уровня: каждый поток считает рёбра и раз в check_every_edges
+    // проверяет условия; после остановки рёбра только пролистываются
+    std::vector<edge_counter> counters(parlay::num_workers());
+    edge_counter* seen = counters.data();
+    std::atomic<int> stop(static_cast<int>(bfs_status::complete));
+    size_t every = options.check_every_edges;
+    size_t reached = 1;
+
+    while (true) {
+        if (options.on_level) {
+            options.on_level({result.level, buf.current_size, reached});
         }
-    );
-
-    size_t log_size = 1;
-    while (log_size < n) {
-        log_size *= 2;
-    }
 
-    size_t* buff_common = static_cast<size_t*>(parlay::p_malloc((3 * n + log_size) * sizeof(size_t)));
-
-    size_t* current = buff_common;
-    size_t* next = buff_common + n;
-    size_t* next_by_node = buff_common + 2 * n;
-    size_t* sizes = buff_common + 3 * n;
+        bfs_status status = check_stop(options);
+        if (status != bfs_status::complete) {
+            result.status = status;
+            return result;
+        }
 
-    visited[start].test_and_set();
-    res[start] = 0;
-    size_t current_size = 1;
-    current[0] = start;
-
-    while (current_size > 0) {
-        parlay::parallel_for(0, current_size,
-            [visited, &edges, &res, next_by_node, sizes, current] (size_t i) {
-                sizes[i] = 0;
-                size_t ind = current[i];
-                size_t curr = ind;
-
-                next_by_node[curr] = curr;
-
-                const std::vector<int>& next_nodes = edges[ind];
-                for (size_t j = 0; j < next_nodes.size(); j++) {
-                    size_t k = static_cast<size_t>(next_nodes[j]);
-
-                    if (!visited[k].test_and_set()) {
-                        res[k] = res[ind] + 1;
-                        sizes[i]++;
-                        next_by_node[curr] = k;
-                        curr = k;
-                        next_by_node[curr] = curr;
+        frontier::expand(edges, buf,
+            [&visited, &options, &stop, dist, seen, every] (size_t from, size_t k) {
+                if (every > 0) {
+                    if (stop.load(std::memory_order_relaxed) != static_cast<int>(bfs_status::complete)) return false;
+                    size_t& count = seen[parlay::worker_id()].value;
+                    if (++count >= every) {
+                        count = 0;
+                        bfs_status s = check_stop(options);
+                        if (s != bfs_status::complete) {
+                            stop.store(static_cast<int>(s), std::memory_order_relaxed);
+                            return false;
+                        }
                     }
                 }
+                if (visited.claim(k)) {
+                    dist[k] = dist[from] + 1;
+                    return true;
+                }
+                return false;
             }
         );
 
-
-        size_t current_size2 = 1;
-        while (current_size2 < current_size) {
-            current_size2 *= 2;
+        int stopped = stop.load();
+        if (stopped != static_cast<int>(bfs_status::complete)) {
+            result.status = static_cast<bfs_status>(stopped);
+            return result;
         }
+        if (buf.current_size == 0) return result;
 
-        parlay::parallel_for(current_size, current_size2,
-            [=] (size_t i) {
-                sizes[i] = 0;
-            }
-        );
-
-        size_t k = scan(sizes, current_size2);
+        result.level++;
+        reached += buf.current_size;
+    }
+}
 
-        parlay::parallel_for(0, current_size,
-            [=] (size_t i) {
-                size_t s = sizes[i];
-                size_t curr = current[i];
-                size_t j = 0;
+}
 
-                while (next_by_node[curr] != curr) {
-                    curr = next_by_node[curr];
-                    next[s + j] = curr;
-                    j++;
-                }
-            }
-        );
+std::vector<int> parallel_bfs(const std::vector<std::vector<int>>& edges, int start) {
+    return bfs_impl(edges, start);
+}
 
+std::vector<int> parallel_bfs(const csr_graph& graph, int start) {
+    return bfs_impl(graph, start);
+}
 
-        std::swap(current, next);
-        current_size = k;
-    }
+std::vector<int> parallel_bfs(const csr_view& graph, int start) {
+    return bfs_impl(graph, start);
+}
 
-    parlay::p_free(buff_common);
-    parlay::p_free(visited);
+bfs_result parallel_bfs(const std::vector<std::vector<int>>& edges, int start, const bfs_options& options) {
+    return bfs_impl(edges, start, options);
+}
 
-    return res;
-}
\ No newline at end of file
+bfs_result parallel_bfs(const csr_graph& graph, int start, const bfs_options& options) {
+    return bfs_impl(graph, start, options);
+}
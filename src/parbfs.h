@@ -1,5 +1,51 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <utility>
 #include <vector>
 
-std::vector<int> parallel_bfs(const std::vector<std::vector<int>>& graph, int start);
\ No newline at end of file
+class csr_graph;
+class csr_view;
+
+// Пары (вершина, расстояние) для достижимых вершин, упорядоченные по расстоянию
+using reached_list = std::vector<std::pair<int, int>>;
+
+std::vector<int> parallel_bfs(const std::vector<std::vector<int>>& graph, int start);
+std::vector<int> parallel_bfs(const csr_graph& graph, int start);
+std::vector<int> parallel_bfs(const csr_view& graph, int start);
+
+struct bfs_progress {
+    int level = 0;
+    size_t frontier_size = 0;
+    // Найдено вершин, включая фронт
+    size_t reached = 0;
+};
+
+// Прерывание обхода. cancel и deadline проверяются на границах уровней, а при
+// check_every_edges > 0 ещё и каждым потоком через столько просмотренных рёбер.
+// on_level вызывается после каждого уровня из вызывающего потока.
+struct bfs_options {
+    const std::atomic<bool>* cancel = nullptr;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    std::function<void(const bfs_progress&)> on_level;
+    size_t check_every_edges = 0;
+};
+
+enum class bfs_status { complete, cancelled, deadline_exceeded };
+
+// При прерывании distance частичный: уровни до level включительно найдены
+// полностью, часть вершин уровня level + 1 может быть уже отмечена, остальные -1.
+// Все отмеченные расстояния точные.
+struct bfs_result {
+    std::vector<int> distance;
+    int level = 0;
+    bfs_status status = bfs_status::complete;
+
+    bool complete() const { return status == bfs_status::complete; }
+};
+
+bfs_result parallel_bfs(const std::vector<std::vector<int>>& graph, int start, const bfs_options& options);
+bfs_result parallel_bfs(const csr_graph& graph, int start, const bfs_options& options);
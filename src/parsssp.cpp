@@ -0,0 +1,213 @@
+#include "parsssp.h"
+#include "arena.h"
+#include "frontier.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+template <typename D>
+class bucket_index {
+public:
+    explicit bucket_index(D delta) : delta_(delta) {
+        if constexpr (std::is_integral_v<D>) {
+            if (delta > 0 && (delta & (delta - 1)) == 0) {
+                shift_ = 0;
+                while ((D(1) << shift_) < delta) shift_++;
+            }
+        }
+    }
+
+    size_t operator()(D d) const {
+        if constexpr (std::is_integral_v<D>) {
+            if (shift_ >= 0) return static_cast<size_t>(d >> shift_);
+        }
+        return static_cast<size_t>(d / delta_);
+    }
+
+private:
+    D delta_;
+    int shift_ = -1;
+};
+
+// Максимальный вес ребра, 0 у графа без рёбер
+template <typename D, typename W>
+D max_weight(const weighted_graph<W>& graph) {
+    constexpr size_t block = 4096;
+    size_t n = graph.size();
+    size_t blocks = (n + block - 1) / block;
+    std::vector<D> block_max(blocks, D(0));
+    parlay::parallel_for(0, blocks,
+        [&] (size_t b) {
+            D m = 0;
+            for (size_t v = b * block; v < std::min(n, (b + 1) * block); v++) {
+                for (const auto& e : graph[v]) m = std::max(m, static_cast<D>(e.second));
+            }
+            block_max[b] = m;
+        }
+    );
+    return block_max.empty() ? D(0) : *std::max_element(block_max.begin(), block_max.end());
+}
+
+template <typename D>
+bool write_min(std::atomic<D>& a, D value) {
+    D cur = a.load(std::memory_order_relaxed);
+    while (value < cur) {
+        if (a.compare_exchange_weak(cur, value)) return true;
+    }
+    return false;
+}
+
+template <typename D, typename W>
+std::vector<D> delta_stepping_impl(const weighted_graph<W>& graph, int start_int, D delta) {
+    // Отрицательная, нулевая или NaN ширина даёт бесконечный цикл по корзинам
+    if (!(delta > 0)) throw std::invalid_argument("delta_stepping: delta must be positive");
+
+    size_t n = graph.size();
+
+    std::vector<D> res(n, -1);
+    size_t start = static_cast<size_t>(start_int);
+
+    if (n == 0) return res;
+
+    const D inf = std::numeric_limits<D>::max();
+    arena::array<std::atomic<D>> dist_holder(n);
+    std::atomic<D>* dist = dist_holder.get();
+
+    parlay::parallel_for(0, n,
+        [=] (size_t i) {
+            dist[i].store(inf, std::memory_order_relaxed);
+        }
+    );
+
+    frontier::visited_flags claimed(n);
+    frontier::visited_flags requeue(n);
+    arena::array<char> in_frontier(n, 0);
+    frontier::buffers buf(n);
+    bucket_index<D> bucket_of(delta);
+
+    // Релаксация из корзины i попадает не дальше i + max_weight / delta + 1,
+    // поэтому корзины [i, i + window) живут в кольце по модулю window. Окно не
+    // больше числа вершин, более далёкие корзины (тяжёлые рёбра при малом
+    // delta) ждут в разреженном far до входа в окно.
+    D span = max_weight<D>(graph) / delta;
+    size_t window = span < static_cast<D>(n) ? static_cast<size_t>(span) + 2 : n + 1;
+    std::vector<std::vector<size_t>> ring(window);
+    std::map<size_t, std::vector<size_t>> far;
+    size_t in_ring = 0;
+    size_t i = 0;
+
+    auto push = [&] (size_t v, size_t b) {
+        if (b - i < window) {
+            ring[b % window].push_back(v);
+            in_ring++;
+        } else {
+            far[b].push_back(v);
+        }
+    };
+
+    auto route = [&] (size_t v) {
+        size_t b = bucket_of(dist[v].load(std::memory_order_relaxed));
+        if (b == i) {
+            in_frontier[v] = 1;
+            buf.current[buf.current_size++] = v;
+        } else {
+            push(v, b);
+        }
+    };
+
+    dist[start].store(0);
+    push(start, 0);
+
+    while (in_ring > 0 || !far.empty()) {
+        // Следующая непустая корзина; пустое кольцо - прыжок к ближайшей из far
+        if (in_ring == 0) i = far.begin()->first;
+        while (!far.empty() && far.begin()->first - i < window) {
+            auto next = far.begin();
+            std::vector<size_t>& slot = ring[next->first % window];
+            slot.insert(slot.end(), next->second.begin(), next->second.end());
+            in_ring += next->second.size();
+            far.erase(next);
+        }
+        while (ring[i % window].empty()) i++;
+
+        // В корзине могут лежать устаревшие копии вершин, уже улучшенных раньше
+        std::vector<size_t> current;
+        current.swap(ring[i % window]);
+        in_ring -= current.size();
+        buf.current_size = 0;
+        for (size_t v : current) {
+            if (!in_frontier[v] && bucket_of(dist[v].load(std::memory_order_relaxed)) == i) {
+                in_frontier[v] = 1;
+                buf.current[buf.current_size++] = v;
+            }
+        }
+
+        while (buf.current_size > 0) {
+            size_t old_size = buf.current_size;
+            const char* frontier_mark = in_frontier.data();
+
+            // Вершину текущего фронта захватывать нельзя, её улучшение
+            // отмечается отдельно и она проходит корзину ещё раз
+            frontier::expand(graph, buf,
+                [dist, frontier_mark, &claimed, &requeue] (size_t from, const std::pair<int, W>& e) {
+                    size_t k = static_cast<size_t>(e.first);
+                    D nd = dist[from].load(std::memory_order_relaxed) + e.second;
+                    if (!write_min(dist[k], nd)) return false;
+                    if (frontier_mark[k]) {
+                        requeue.claim(k);
+                        return false;
+                    }
+                    return claimed.claim(k);
+                }
+            );
+
+            // После expand старый фронт лежит в buf.next
+            size_t* old_frontier = buf.next;
+            size_t* found = buf.current;
+            size_t found_size = buf.current_size;
+            std::atomic_flag* claimed_flags = claimed.data();
+
+            parlay::parallel_for(0, found_size,
+                [=] (size_t j) {
+                    claimed_flags[found[j]].clear();
+                }
+            );
+            for (size_t j = 0; j < old_size; j++) {
+                in_frontier[old_frontier[j]] = 0;
+            }
+
+            buf.current_size = 0;
+            for (size_t j = 0; j < found_size; j++) {
+                route(found[j]);
+            }
+            std::atomic_flag* requeue_flags = requeue.data();
+            for (size_t j = 0; j < old_size; j++) {
+                size_t v = old_frontier[j];
+                if (requeue_flags[v].test_and_set()) route(v);
+                requeue_flags[v].clear();
+            }
+        }
+    }
+
+    parlay::parallel_for(0, n,
+        [&res, dist, inf] (size_t i) {
+            D d = dist[i].load(std::memory_order_relaxed);
+            res[i] = d == inf ? D(-1) : d;
+        }
+    );
+
+    return res;
+}
+}
+
+std::vector<double> delta_stepping(const weighted_graph<double>& graph, int start, double delta) {
+    return delta_stepping_impl<double>(graph, start, delta);
+}
+
+std::vector<long long> delta_stepping(const weighted_graph<int>& graph, int start, long long delta) {
+    return delta_stepping_impl<long long>(graph, start, delta);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "weighted_graph.h"
+#include <vector>
+
+// Параллельный delta-stepping. Вершины обрабатываются корзинами ширины delta
+// по возрастанию расстояния, внутри корзины - уровнями через frontier::expand.
+// Недостижимые вершины получают -1. Для целых весов корзина считается
+// целочисленным делением, а при delta - степени двойки сдвигом.
+// При delta <= 0 или NaN бросает std::invalid_argument.
+std::vector<double> delta_stepping(const weighted_graph<double>& graph, int start, double delta);
+std::vector<long long> delta_stepping(const weighted_graph<int>& graph, int start, long long delta);
@@ -0,0 +1,259 @@
+#include "partbfs.h"
+#include <algorithm>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+size_t partition_begin(size_t n, int ranks, int rank) {
+    return n * static_cast<size_t>(rank) / static_cast<size_t>(ranks);
+}
+
+namespace {
+int owner(size_t n, int ranks, size_t v) {
+    int r = static_cast<int>(v * ranks / n);
+    // Поправка на округление границ
+    while (r + 1 < ranks && partition_begin(n, ranks, r + 1) <= v) r++;
+    while (partition_begin(n, ranks, r) > v) r--;
+    return r;
+}
+}
+
+std::vector<int> partitioned_bfs_rank(const std::vector<std::vector<int>>& local_graph,
+                                      size_t n, int start, transport& net,
+                                      partition_stats* stats) {
+    int ranks = net.ranks();
+    int me = net.rank();
+    size_t lo = partition_begin(n, ranks, me);
+
+    std::vector<int> dist(local_graph.size(), -1);
+    std::vector<int> current;
+    std::vector<int> next;
+    std::vector<std::vector<int>> outgoing(ranks);
+
+    size_t s = static_cast<size_t>(start);
+    if (s >= lo && s - lo < local_graph.size()) {
+        dist[s - lo] = 0;
+        current.push_back(start);
+    }
+
+    if (stats != nullptr) {
+        stats->ranks = ranks;
+        stats->levels.clear();
+        stats->total_bytes = 0;
+    }
+
+    for (int level = 0;; level++) {
+        long long frontier = net.all_reduce_sum(static_cast<long long>(current.size()));
+        if (frontier == 0) break;
+        long long max_frontier = net.all_reduce_max(static_cast<long long>(current.size()));
+
+        next.clear();
+        for (auto& out : outgoing) out.clear();
+
+        for (int v : current) {
+            for (int u : local_graph[v - lo]) {
+                int r = owner(n, ranks, u);
+                if (r == me) {
+                    if (dist[u - lo] == -1) {
+                        dist[u - lo] = level + 1;
+                        next.push_back(u);
+                    }
+                } else {
+                    outgoing[r].push_back(u);
+                }
+            }
+        }
+
+        // Одна вершина отправляется владельцу не больше одного раза за уровень
+        long long messages = 0;
+        for (auto& out : outgoing) {
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+            messages += static_cast<long long>(out.size());
+        }
+
+        for (int u : net.exchange(outgoing)) {
+            if (dist[u - lo] == -1) {
+                dist[u - lo] = level + 1;
+                next.push_back(u);
+            }
+        }
+
+        messages = net.all_reduce_sum(messages);
+        if (stats != nullptr) {
+            partition_level_stats ls;
+            ls.frontier = frontier;
+            ls.max_rank_frontier = max_frontier;
+            ls.messages = messages;
+            ls.bytes = messages * static_cast<long long>(sizeof(int));
+            ls.imbalance = static_cast<double>(max_frontier) * ranks / frontier;
+            stats->levels.push_back(ls);
+            stats->total_bytes += ls.bytes;
+        }
+
+        std::swap(current, next);
+    }
+
+    return dist;
+}
+
+#ifndef _WIN32
+
+namespace {
+bool write_all(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t w = write(fd, p, size);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        size -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+// Ждёт завершения рангов, по ходу вычитывая pipe (ранг 0 не должен встать на
+// полном pipe). Если ранг упал, остальные ждали бы его на барьере вечно -
+// их убиваем. true, если все ранги завершились с кодом 0.
+bool wait_ranks(const std::vector<pid_t>& children, bool all_started, int fd, std::vector<char>& data) {
+    std::vector<char> done(children.size(), 0);
+    size_t running = children.size();
+    bool ok = all_started;
+    bool pipe_open = true;
+    bool killed = false;
+    char buf[4096];
+
+    while (running > 0 || pipe_open) {
+        if (!ok && !killed) {
+            for (size_t i = 0; i < children.size(); i++) {
+                if (!done[i]) kill(children[i], SIGKILL);
+            }
+            killed = true;
+        }
+
+        if (pipe_open) {
+            pollfd p = {fd, POLLIN, 0};
+            int ready = poll(&p, 1, 10);
+            if (ready > 0) {
+                ssize_t r = read(fd, buf, sizeof(buf));
+                if (r > 0) {
+                    data.insert(data.end(), buf, buf + r);
+                } else if (r == 0 || errno != EINTR) {
+                    pipe_open = false;
+                }
+            }
+        } else {
+            poll(nullptr, 0, 10);
+        }
+
+        for (size_t i = 0; i < children.size(); i++) {
+            if (done[i]) continue;
+            int status = 0;
+            pid_t w = waitpid(children[i], &status, WNOHANG);
+            if (w == 0 || (w < 0 && errno == EINTR)) continue;
+            done[i] = 1;
+            running--;
+            if (w < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+        }
+    }
+    return ok;
+}
+}
+
+// Дочерние процессы не трогают планировщик parlay: после fork его потоков
+// в процессе нет, поэтому работа ранга последовательная.
+std::vector<int> partitioned_bfs(const std::vector<std::vector<int>>& graph, int start, int ranks,
+                                 partition_stats* stats, size_t batch_capacity) {
+    size_t n = graph.size();
+    std::vector<int> res(n, -1);
+    if (n == 0) return res;
+    ranks = std::max(1, std::min(ranks, static_cast<int>(n)));
+
+    shm_transport_region region(ranks, batch_capacity);
+
+    size_t result_bytes = n * sizeof(int);
+    void* shared = mmap(nullptr, result_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) throw std::runtime_error("mmap of result buffer failed");
+    int* shared_res = static_cast<int*>(shared);
+
+    // Статистику уровней ранг 0 передаёт через pipe
+    int fds[2];
+    if (pipe(fds) != 0) {
+        munmap(shared, result_bytes);
+        throw std::runtime_error("pipe failed");
+    }
+
+    std::vector<pid_t> children;
+    for (int r = 0; r < ranks; r++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            // Исключение не должно выйти из ребёнка: дальше по стеку код родителя
+            try {
+                close(fds[0]);
+                size_t lo = partition_begin(n, ranks, r);
+                size_t hi = partition_begin(n, ranks, r + 1);
+                std::vector<std::vector<int>> local(graph.begin() + lo, graph.begin() + hi);
+
+                std::unique_ptr<transport> net = region.attach(r);
+                partition_stats local_stats;
+                std::vector<int> dist = partitioned_bfs_rank(local, n, start, *net, &local_stats);
+                std::copy(dist.begin(), dist.end(), shared_res + lo);
+
+                bool ok = true;
+                if (r == 0) {
+                    size_t levels = local_stats.levels.size();
+                    ok = write_all(fds[1], &levels, sizeof(levels)) &&
+                         write_all(fds[1], local_stats.levels.data(), levels * sizeof(partition_level_stats));
+                }
+                close(fds[1]);
+                _exit(ok ? 0 : 1);
+            } catch (...) {
+                _exit(1);
+            }
+        }
+        if (pid < 0) break;
+        children.push_back(pid);
+    }
+    close(fds[1]);
+
+    // Если не все ранги запустились, уже запущенные навсегда встанут на барьере
+    std::vector<char> stats_data;
+    bool ok = wait_ranks(children, static_cast<int>(children.size()) == ranks, fds[0], stats_data);
+    close(fds[0]);
+
+    size_t levels = 0;
+    std::vector<partition_level_stats> level_stats;
+    if (ok && stats_data.size() >= sizeof(levels)) {
+        std::memcpy(&levels, stats_data.data(), sizeof(levels));
+        ok = stats_data.size() == sizeof(levels) + levels * sizeof(partition_level_stats);
+        if (ok) {
+            level_stats.resize(levels);
+            std::memcpy(level_stats.data(), stats_data.data() + sizeof(levels), levels * sizeof(partition_level_stats));
+        }
+    } else {
+        ok = false;
+    }
+
+    if (ok) std::copy(shared_res, shared_res + n, res.begin());
+    munmap(shared, result_bytes);
+    if (!ok) throw std::runtime_error("partitioned_bfs: rank process failed");
+
+    if (stats != nullptr) {
+        stats->ranks = ranks;
+        stats->levels = std::move(level_stats);
+        stats->total_bytes = 0;
+        for (const auto& ls : stats->levels) stats->total_bytes += ls.bytes;
+    }
+
+    return res;
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "transport.h"
+#include <cstddef>
+#include <vector>
+
+struct partition_level_stats {
+    long long frontier = 0;
+    // Наибольший фронт среди рангов, дисбаланс = max / среднее
+    long long max_rank_frontier = 0;
+    long long messages = 0;
+    long long bytes = 0;
+    double imbalance = 0;
+};
+
+struct partition_stats {
+    int ranks = 0;
+    std::vector<partition_level_stats> levels;
+    long long total_bytes = 0;
+};
+
+// Одномерное разбиение: ранг r владеет вершинами [n * r / ranks, n * (r + 1) / ranks)
+size_t partition_begin(size_t n, int ranks, int rank);
+
+// Часть BFS одного ранга. local_graph - списки смежности собственных вершин
+// (соседи в глобальной нумерации). Возвращает расстояния собственных вершин.
+// Статистика уровней собирается на всех рангах одинаково.
+std::vector<int> partitioned_bfs_rank(const std::vector<std::vector<int>>& local_graph,
+                                      size_t n, int start, transport& net,
+                                      partition_stats* stats = nullptr);
+
+#ifndef _WIN32
+
+// Запускает ranks локальных процессов с транспортом через разделяемую память
+// и собирает расстояния. Каждый процесс берёт из graph только свою часть.
+std::vector<int> partitioned_bfs(const std::vector<std::vector<int>>& graph, int start, int ranks,
+                                 partition_stats* stats = nullptr,
+                                 size_t batch_capacity = 1 << 16);
+
+#endif
@@ -0,0 +1,201 @@
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+#ifdef __linux__
+
+namespace {
+
+std::vector<int> process_threads() {
+    std::vector<int> tids;
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) return tids;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        tids.push_back(std::atoi(entry->d_name));
+    }
+    closedir(dir);
+    return tids;
+}
+
+void describe(perf_counter::event e, perf_event_attr& attr) {
+    switch (e) {
+    case perf_counter::event::dtlb_load_misses:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case perf_counter::event::cycles:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case perf_counter::event::instructions:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case perf_counter::event::cache_misses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case perf_counter::event::branch_misses:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+}
+
+int open_event(perf_counter::event e, int tid, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    describe(e, attr);
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = group_fd < 0 ? PERF_FORMAT_GROUP : 0;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, group_fd, 0));
+}
+
+}
+
+perf_counter::perf_counter(event e) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    describe(e, attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    for (int tid : process_threads()) {
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+        if (fd < 0) {
+            // Частично открытый набор недостоверен
+            for (int open_fd : fds_) close(open_fd);
+            fds_.clear();
+            return;
+        }
+        fds_.push_back(fd);
+    }
+}
+
+perf_counter::~perf_counter() {
+    for (int fd : fds_) close(fd);
+}
+
+void perf_counter::start() {
+    for (int fd : fds_) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perf_counter::stop() {
+    for (int fd : fds_) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+}
+
+uint64_t perf_counter::read() const {
+    uint64_t total = 0;
+    for (int fd : fds_) {
+        uint64_t value = 0;
+        if (::read(fd, &value, sizeof(value)) == sizeof(value)) total += value;
+    }
+    return total;
+}
+
+perf_counter_set::perf_counter_set(const std::vector<perf_counter::event>& events)
+    : events_(events), slot_(events.size(), -1) {
+    std::vector<int> tids = process_threads();
+    if (tids.empty()) return;
+
+    // Состав группы определяется на первом потоке
+    int leader = -1;
+    for (size_t i = 0; i < events_.size(); i++) {
+        int fd = open_event(events_[i], tids[0], leader);
+        if (fd < 0) continue;
+        if (leader < 0) leader = fd;
+        slot_[i] = static_cast<int>(group_size_++);
+        fds_.push_back(fd);
+    }
+
+    for (size_t t = 1; t < tids.size() && !fds_.empty(); t++) {
+        leader = -1;
+        for (size_t i = 0; i < events_.size(); i++) {
+            if (slot_[i] < 0) continue;
+            int fd = open_event(events_[i], tids[t], leader);
+            if (fd < 0) {
+                for (int open_fd : fds_) close(open_fd);
+                fds_.clear();
+                break;
+            }
+            if (leader < 0) leader = fd;
+            fds_.push_back(fd);
+        }
+    }
+
+    if (fds_.empty()) {
+        slot_.assign(events_.size(), -1);
+        group_size_ = 0;
+    }
+}
+
+perf_counter_set::~perf_counter_set() {
+    for (int fd : fds_) close(fd);
+}
+
+void perf_counter_set::start() {
+    for (size_t i = 0; i < fds_.size(); i += group_size_) {
+        ioctl(fds_[i], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void perf_counter_set::stop() {
+    for (size_t i = 0; i < fds_.size(); i += group_size_) {
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void perf_counter_set::read(uint64_t* values) const {
+    std::vector<uint64_t> totals(group_size_, 0);
+    // Формат PERF_FORMAT_GROUP: число событий, затем значения
+    std::vector<uint64_t> buf(group_size_ + 1);
+    for (size_t i = 0; i < fds_.size(); i += group_size_) {
+        ssize_t bytes = static_cast<ssize_t>(buf.size() * sizeof(uint64_t));
+        if (::read(fds_[i], buf.data(), buf.size() * sizeof(uint64_t)) != bytes) continue;
+        for (size_t j = 0; j < group_size_ && j < buf[0]; j++) {
+            totals[j] += buf[j + 1];
+        }
+    }
+    for (size_t i = 0; i < events_.size(); i++) {
+        values[i] = slot_[i] >= 0 ? totals[slot_[i]] : 0;
+    }
+}
+
+#else
+
+perf_counter::perf_counter(event) {}
+perf_counter::~perf_counter() {}
+void perf_counter::start() {}
+void perf_counter::stop() {}
+uint64_t perf_counter::read() const { return 0; }
+
+perf_counter_set::perf_counter_set(const std::vector<perf_counter::event>& events)
+    : events_(events), slot_(events.size(), -1) {}
+perf_counter_set::~perf_counter_set() {}
+void perf_counter_set::start() {}
+void perf_counter_set::stop() {}
+void perf_counter_set::read(uint64_t* values) const {
+    for (size_t i = 0; i < events_.size(); i++) values[i] = 0;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Аппаратный счётчик через perf_event_open, считает по всем потокам процесса
+// (на момент создания), только user-space. Если счётчик открыть не удалось
+// (не Linux, perf_event_paranoid, виртуализация), available() == false, а
+// read() возвращает 0.
+class perf_counter {
+public:
+    // cache_misses - промахи последнего уровня кэша
+    enum class event { dtlb_load_misses, cycles, instructions, cache_misses, branch_misses };
+
+    explicit perf_counter(event e);
+    ~perf_counter();
+
+    perf_counter(const perf_counter&) = delete;
+    perf_counter& operator=(const perf_counter&) = delete;
+
+    bool available() const { return !fds_.empty(); }
+
+    void start();
+    void stop();
+    uint64_t read() const;
+
+private:
+    std::vector<int> fds_;
+};
+
+// Несколько событий одной группой на каждый поток: все события группы
+// считаются одновременно, read() - одно чтение на поток. События, которые
+// не открылись, пропускаются (available(i) == false, значение 0); если на
+// каком-то потоке не открылась группа, недоступно всё. Счётчики включаются
+// в start() и дальше только читаются, разности снимков дают расход между ними.
+class perf_counter_set {
+public:
+    explicit perf_counter_set(const std::vector<perf_counter::event>& events);
+    ~perf_counter_set();
+
+    perf_counter_set(const perf_counter_set&) = delete;
+    perf_counter_set& operator=(const perf_counter_set&) = delete;
+
+    size_t size() const { return events_.size(); }
+    perf_counter::event event(size_t i) const { return events_[i]; }
+    bool available(size_t i) const { return slot_[i] >= 0; }
+    bool any_available() const { return !fds_.empty(); }
+
+    void start();
+    void stop();
+    // values - size() элементов, суммы по потокам с момента start()
+    void read(uint64_t* values) const;
+
+private:
+    std::vector<perf_counter::event> events_;
+    // Номер события в группе или -1
+    std::vector<int> slot_;
+    size_t group_size_ = 0;
+    // Лидер группы потока - первый из group_size_ подряд идущих
+    std::vector<int> fds_;
+};
@@ -0,0 +1,121 @@
+#include "query_batch.h"
+#include "parbfs.h"
+#include "arena.h"
+#include <parlay/parallel.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+// Расстояния размера n заводятся один раз на поток и после каждого запроса
+// сбрасываются только в посещённых вершинах
+struct workspace {
+    explicit workspace(size_t n) : dist(n, -1) {}
+
+    arena::array<int> dist;
+    std::vector<int> queue;
+};
+
+// false, если запрос превысил лимит и должен выполняться параллельно
+bool small_bfs(const std::vector<std::vector<int>>& graph, int start, size_t limit,
+               workspace& ws, reached_list& out) {
+    arena::array<int>& dist = ws.dist;
+    std::vector<int>& queue = ws.queue;
+    queue.clear();
+    queue.push_back(start);
+    dist[start] = 0;
+
+    bool fits = true;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int v = queue[head];
+        for (int u : graph[v]) {
+            if (dist[u] == -1) {
+                dist[u] = dist[v] + 1;
+                queue.push_back(u);
+            }
+        }
+        if (queue.size() > limit) {
+            fits = false;
+            break;
+        }
+    }
+
+    if (fits) {
+        out.resize(queue.size());
+        for (size_t i = 0; i < queue.size(); i++) {
+            out[i] = {queue[i], dist[queue[i]]};
+        }
+    }
+
+    for (int v : queue) dist[v] = -1;
+    return fits;
+}
+
+double percentile(std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t idx = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+}
+
+std::vector<reached_list> bfs_batch(const std::vector<std::vector<int>>& graph,
+                                    const std::vector<int>& sources,
+                                    batch_stats* stats,
+                                    size_t small_limit) {
+    size_t q = sources.size();
+    std::vector<reached_list> results(q);
+    std::vector<double> latency(q, 0);
+    std::vector<char> large(q, 0);
+
+    auto batch_start = clock_type::now();
+
+    std::vector<std::unique_ptr<workspace>> workspaces(parlay::num_workers());
+
+    parlay::parallel_for(0, q,
+        [&] (size_t i) {
+            auto t0 = clock_type::now();
+            std::unique_ptr<workspace>& ws = workspaces[parlay::worker_id()];
+            if (!ws) ws = std::make_unique<workspace>(graph.size());
+
+            if (!small_bfs(graph, sources[i], small_limit, *ws, results[i])) {
+                large[i] = 1;
+            }
+            latency[i] = std::chrono::duration<double, std::milli>(clock_type::now() - t0).count();
+        }, 1
+    );
+
+    size_t large_count = 0;
+    for (size_t i = 0; i < q; i++) {
+        if (!large[i]) continue;
+        large_count++;
+
+        auto t0 = clock_type::now();
+        std::vector<int> dist = parallel_bfs(graph, sources[i]);
+
+        reached_list& out = results[i];
+        for (size_t v = 0; v < dist.size(); v++) {
+            if (dist[v] >= 0) out.emplace_back(static_cast<int>(v), dist[v]);
+        }
+        std::stable_sort(out.begin(), out.end(),
+            [] (const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                return a.second < b.second;
+            }
+        );
+        latency[i] += std::chrono::duration<double, std::milli>(clock_type::now() - t0).count();
+    }
+
+    if (stats != nullptr) {
+        stats->queries = q;
+        stats->large_queries = large_count;
+        stats->seconds = std::chrono::duration<double>(clock_type::now() - batch_start).count();
+        stats->queries_per_sec = stats->seconds > 0 ? q / stats->seconds : 0;
+        std::sort(latency.begin(), latency.end());
+        stats->p50_ms = percentile(latency, 0.50);
+        stats->p99_ms = percentile(latency, 0.99);
+        stats->max_ms = latency.empty() ? 0 : latency.back();
+    }
+
+    return results;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "parbfs.h"
+#include <cstddef>
+#include <vector>
+
+struct batch_stats {
+    size_t queries = 0;
+    size_t large_queries = 0;
+    double seconds = 0;
+    double queries_per_sec = 0;
+    // Время обслуживания одного запроса
+    double p50_ms = 0;
+    double p99_ms = 0;
+    double max_ms = 0;
+};
+
+// Независимые BFS из каждого источника на общем графе. Запросы раздаются
+// потокам целиком и выполняются последовательно на рабочих пространствах
+// потоков; запрос, достигший small_limit вершин, прерывается и потом
+// выполняется через parallel_bfs на всех потоках.
+std::vector<reached_list> bfs_batch(const std::vector<std::vector<int>>& graph,
+                                    const std::vector<int>& sources,
+                                    batch_stats* stats = nullptr,
+                                    size_t small_limit = 1 << 16);
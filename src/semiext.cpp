@@ -0,0 +1,163 @@
+#include "semiext.h"
+#include "arena.h"
+#include "frontier.h"
+#include "graph_file.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+
+namespace {
+struct block {
+    size_t begin;
+    size_t end;
+};
+
+// Блоки подряд идущих вершин, чьи списки занимают не больше block_bytes;
+// вершина с большей степенью получает блок целиком
+std::vector<block> split_blocks(const std::vector<uint64_t>& offsets, size_t block_bytes) {
+    size_t n = offsets.size() - 1;
+    size_t max_edges = std::max<size_t>(1, block_bytes / sizeof(int));
+    std::vector<block> blocks;
+
+    size_t begin = 0;
+    while (begin < n) {
+        size_t end = begin + 1;
+        while (end < n && offsets[end + 1] - offsets[begin] <= max_edges) end++;
+        blocks.push_back({begin, end});
+        begin = end;
+    }
+    return blocks;
+}
+
+class block_reader {
+public:
+    block_reader(const std::string& path, const graph_file_header& header)
+        : in_(path, std::ios::binary), targets_position_(header.targets_position()) {
+        if (!in_) throw std::runtime_error("cannot open graph file " + path);
+    }
+
+    // Вызывается не более чем из одного потока одновременно
+    std::vector<int> read(uint64_t first_edge, uint64_t edges) {
+        std::vector<int> data(edges);
+        in_.seekg(static_cast<std::streamoff>(targets_position_ + first_edge * sizeof(int)));
+        in_.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(edges * sizeof(int)));
+        if (!in_) throw std::runtime_error("truncated graph file");
+        return data;
+    }
+
+private:
+    std::ifstream in_;
+    uint64_t targets_position_;
+};
+}
+
+std::vector<int> semi_external_bfs(const std::string& path, int start_int,
+                                   semi_external_stats* stats, size_t block_bytes) {
+    graph_file_header header = read_graph_header(path);
+    std::vector<uint64_t> offsets = read_graph_offsets(path, header);
+    size_t n = header.n;
+
+    std::vector<int> res(n, -1);
+    if (stats != nullptr) *stats = semi_external_stats();
+    if (n == 0) return res;
+
+    std::vector<block> blocks = split_blocks(offsets, block_bytes);
+    arena::array<size_t> block_of(n);
+    for (size_t b = 0; b < blocks.size(); b++) {
+        std::fill(block_of.begin() + blocks[b].begin, block_of.begin() + blocks[b].end, b);
+    }
+
+    size_t words = (n + 63) / 64;
+    arena::array<std::atomic<uint64_t>> current_bits(words);
+    arena::array<std::atomic<uint64_t>> next_bits(words);
+    arena::array<std::atomic<size_t>> current_count(blocks.size());
+    arena::array<std::atomic<size_t>> next_count(blocks.size());
+    for (size_t w = 0; w < words; w++) {
+        current_bits[w].store(0, std::memory_order_relaxed);
+        next_bits[w].store(0, std::memory_order_relaxed);
+    }
+    for (size_t b = 0; b < blocks.size(); b++) {
+        current_count[b].store(0, std::memory_order_relaxed);
+        next_count[b].store(0, std::memory_order_relaxed);
+    }
+
+    frontier::visited_flags visited(n);
+    block_reader reader(path, header);
+
+    size_t start = static_cast<size_t>(start_int);
+    visited.claim(start);
+    res[start] = 0;
+    current_bits[start / 64].store(uint64_t(1) << (start % 64));
+    current_count[block_of[start]].store(1);
+    size_t frontier_size = 1;
+
+    if (stats != nullptr) stats->blocks = blocks.size();
+
+    for (int level = 0; frontier_size > 0; level++) {
+        semi_external_level_stats level_stats;
+
+        std::vector<size_t> active;
+        for (size_t b = 0; b < blocks.size(); b++) {
+            if (current_count[b].load(std::memory_order_relaxed) > 0) active.push_back(b);
+        }
+        level_stats.blocks_read = active.size();
+        level_stats.blocks_skipped = blocks.size() - active.size();
+
+        auto fetch = [&reader, &offsets, &blocks] (size_t b) {
+            return reader.read(offsets[blocks[b].begin], offsets[blocks[b].end] - offsets[blocks[b].begin]);
+        };
+
+        std::atomic<size_t> found(0);
+        std::future<std::vector<int>> pending;
+        if (!active.empty()) pending = std::async(std::launch::async, fetch, active[0]);
+
+        for (size_t i = 0; i < active.size(); i++) {
+            std::vector<int> adjacency = pending.get();
+            if (i + 1 < active.size()) pending = std::async(std::launch::async, fetch, active[i + 1]);
+
+            const block& blk = blocks[active[i]];
+            level_stats.bytes_read += adjacency.size() * sizeof(int);
+            uint64_t base = offsets[blk.begin];
+            int next_level = level + 1;
+
+            parlay::parallel_for(blk.begin, blk.end,
+                [&] (size_t v) {
+                    if (!(current_bits[v / 64].load(std::memory_order_relaxed) >> (v % 64) & 1)) return;
+                    for (uint64_t e = offsets[v]; e < offsets[v + 1]; e++) {
+                        size_t u = static_cast<size_t>(adjacency[e - base]);
+                        if (visited.claim(u)) {
+                            res[u] = next_level;
+                            next_bits[u / 64].fetch_or(uint64_t(1) << (u % 64), std::memory_order_relaxed);
+                            next_count[block_of[u]].fetch_add(1, std::memory_order_relaxed);
+                            found.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }, 1024
+            );
+        }
+
+        // Следующий фронт становится текущим, старые карты обнуляются
+        std::atomic<uint64_t>* cur = current_bits.get();
+        std::atomic<uint64_t>* nxt = next_bits.get();
+        parlay::parallel_for(0, words,
+            [=] (size_t w) {
+                cur[w].store(nxt[w].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                nxt[w].store(0, std::memory_order_relaxed);
+            }
+        );
+        for (size_t b = 0; b < blocks.size(); b++) {
+            current_count[b].store(next_count[b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            next_count[b].store(0, std::memory_order_relaxed);
+        }
+        frontier_size = found.load();
+
+        if (stats != nullptr) {
+            stats->levels.push_back(level_stats);
+            stats->total_bytes_read += level_stats.bytes_read;
+        }
+    }
+
+    return res;
+}
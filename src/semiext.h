@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct semi_external_level_stats {
+    uint64_t bytes_read = 0;
+    size_t blocks_read = 0;
+    size_t blocks_skipped = 0;
+};
+
+struct semi_external_stats {
+    std::vector<semi_external_level_stats> levels;
+    uint64_t total_bytes_read = 0;
+    size_t blocks = 0;
+};
+
+// BFS по графу в файле формата graph_file.h. В памяти только состояние
+// вершин: расстояния, флаги посещения, битовые карты фронтов и смещения
+// списков. Списки смежности читаются блоками по ~block_bytes подряд идущих
+// вершин, блоки без вершин фронта пропускаются, чтение следующего блока
+// идёт в фоне, пока обрабатывается текущий.
+std::vector<int> semi_external_bfs(const std::string& path, int start,
+                                   semi_external_stats* stats = nullptr,
+                                   size_t block_bytes = size_t(64) << 20);
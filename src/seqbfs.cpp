@@ -1,5 +1,6 @@
 #include "seqbfs.h"
 #include <queue>
+#include <cstddef>
 
 // Если писать нормальный BFS, то это не честно
 std::vector<int> sequential_bfs(const std::vector<std::vector<int>>& graph, int start) {
@@ -0,0 +1,37 @@
+#include "seqsssp.h"
+#include <functional>
+#include <queue>
+
+namespace {
+template <typename D, typename W>
+std::vector<D> dijkstra(const weighted_graph<W>& graph, int start) {
+    std::vector<D> res(graph.size(), -1);
+    std::priority_queue<std::pair<D, int>, std::vector<std::pair<D, int>>, std::greater<>> heap;
+
+    res[start] = 0;
+    heap.emplace(0, start);
+    while (!heap.empty()) {
+        auto [d, v] = heap.top();
+        heap.pop();
+        if (d != res[v]) continue;
+
+        for (const auto& [u, w] : graph[v]) {
+            D nd = d + w;
+            if (res[u] < 0 || nd < res[u]) {
+                res[u] = nd;
+                heap.emplace(nd, u);
+            }
+        }
+    }
+
+    return res;
+}
+}
+
+std::vector<double> sequential_dijkstra(const weighted_graph<double>& graph, int start) {
+    return dijkstra<double>(graph, start);
+}
+
+std::vector<long long> sequential_dijkstra(const weighted_graph<int>& graph, int start) {
+    return dijkstra<long long>(graph, start);
+}
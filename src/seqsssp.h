@@ -0,0 +1,8 @@
+#pragma once
+
+#include "weighted_graph.h"
+#include <vector>
+
+// Дейкстра с кучей, недостижимые вершины получают -1
+std::vector<double> sequential_dijkstra(const weighted_graph<double>& graph, int start);
+std::vector<long long> sequential_dijkstra(const weighted_graph<int>& graph, int start);
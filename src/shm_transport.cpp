@@ -0,0 +1,156 @@
+#include "transport.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+struct region_header {
+    pthread_barrier_t barrier;
+};
+
+size_t align_up(size_t x) {
+    return (x + 63) / 64 * 64;
+}
+
+size_t mailbox_bytes(size_t capacity) {
+    return align_up(sizeof(size_t) + capacity * sizeof(int));
+}
+
+size_t slots_offset() {
+    return align_up(sizeof(region_header));
+}
+
+size_t mailboxes_offset(int ranks) {
+    return slots_offset() + align_up(ranks * sizeof(long long));
+}
+}
+
+// Почтовый ящик (src, dst) хранит число элементов и до capacity элементов.
+// Каждый раунд: запись в свои ящики, барьер, чтение своих входящих,
+// редукция остатка (в ней ещё два барьера, после которых ящики снова свободны).
+class shm_transport : public transport {
+public:
+    shm_transport(shm_transport_region& region, int rank) : region_(region), rank_(rank) {}
+
+    int rank() const override { return rank_; }
+    int ranks() const override { return region_.ranks_; }
+
+    std::vector<int> exchange(const std::vector<std::vector<int>>& outgoing) override {
+        int p = region_.ranks_;
+        std::vector<int> received;
+        std::vector<size_t> sent(p, 0);
+
+        while (true) {
+            long long remaining = 0;
+            for (int dst = 0; dst < p; dst++) {
+                size_t total = dst < static_cast<int>(outgoing.size()) ? outgoing[dst].size() : 0;
+                size_t count = std::min(region_.capacity_, total - sent[dst]);
+                size_t* box = mailbox(rank_, dst);
+                *box = count;
+                if (count > 0) {
+                    std::memcpy(box + 1, outgoing[dst].data() + sent[dst], count * sizeof(int));
+                }
+                sent[dst] += count;
+                remaining += static_cast<long long>(total - sent[dst]);
+            }
+
+            barrier();
+
+            for (int src = 0; src < p; src++) {
+                size_t* box = mailbox(src, rank_);
+                const int* data = reinterpret_cast<const int*>(box + 1);
+                received.insert(received.end(), data, data + *box);
+            }
+
+            if (all_reduce_sum(remaining) == 0) break;
+        }
+
+        return received;
+    }
+
+    long long all_reduce_sum(long long value) override {
+        long long res = 0;
+        for (long long x : gather(value)) res += x;
+        return res;
+    }
+
+    long long all_reduce_max(long long value) override {
+        std::vector<long long> all = gather(value);
+        return *std::max_element(all.begin(), all.end());
+    }
+
+private:
+    std::vector<long long> gather(long long value) {
+        long long* slots = reinterpret_cast<long long*>(base() + slots_offset());
+        slots[rank_] = value;
+        barrier();
+        std::vector<long long> all(region_.ranks_);
+        std::copy(slots, slots + region_.ranks_, all.begin());
+        barrier();
+        return all;
+    }
+
+    void barrier() {
+        pthread_barrier_wait(&reinterpret_cast<region_header*>(base())->barrier);
+    }
+
+    char* base() { return static_cast<char*>(region_.base_); }
+
+    size_t* mailbox(int src, int dst) {
+        size_t idx = static_cast<size_t>(src) * region_.ranks_ + dst;
+        return reinterpret_cast<size_t*>(base() + mailboxes_offset(region_.ranks_) +
+                                         idx * mailbox_bytes(region_.capacity_));
+    }
+
+    shm_transport_region& region_;
+    int rank_;
+};
+
+shm_transport_region::shm_transport_region(int ranks, size_t batch_capacity)
+    : ranks_(ranks), capacity_(batch_capacity) {
+    if (ranks <= 0 || batch_capacity == 0) throw std::invalid_argument("shm_transport_region: bad size");
+
+    bytes_ = mailboxes_offset(ranks) + static_cast<size_t>(ranks) * ranks * mailbox_bytes(batch_capacity);
+
+    // Имя нужно только на время создания: после mmap объект сразу удаляется
+    static std::atomic<int> counter(0);
+    std::string name = "/parbfs_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw std::runtime_error("shm_open failed");
+    shm_unlink(name.c_str());
+
+    if (ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+        close(fd);
+        throw std::runtime_error("ftruncate of shared memory failed");
+    }
+    base_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base_ == MAP_FAILED) throw std::runtime_error("mmap of shared memory failed");
+
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&static_cast<region_header*>(base_)->barrier, &attr, ranks);
+    pthread_barrierattr_destroy(&attr);
+}
+
+shm_transport_region::~shm_transport_region() {
+    // pthread_barrier_destroy не вызываем: если ранг убит посреди barrier(),
+    // destroy ждёт его вечно. Барьер живёт только в этой памяти, munmap достаточно
+    munmap(base_, bytes_);
+}
+
+std::unique_ptr<transport> shm_transport_region::attach(int rank) {
+    return std::make_unique<shm_transport>(*this, rank);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Обмен сообщениями между рангами распределённого BFS. Все вызовы
+// коллективные: каждый ранг обязан вызвать их в одном и том же порядке.
+class transport {
+public:
+    virtual ~transport() = default;
+
+    virtual int rank() const = 0;
+    virtual int ranks() const = 0;
+
+    // outgoing[r] уходит рангу r, возвращается всё, что прислали этому рангу.
+    // Большие объёмы передаются несколькими пакетами.
+    virtual std::vector<int> exchange(const std::vector<std::vector<int>>& outgoing) = 0;
+
+    virtual long long all_reduce_sum(long long value) = 0;
+    virtual long long all_reduce_max(long long value) = 0;
+};
+
+#ifndef _WIN32
+
+// Локальные процессы поверх разделяемой памяти POSIX. Область создаётся
+// до fork, дочерние процессы получают её по наследству и подключаются
+// к ней через attach со своим номером ранга.
+class shm_transport_region {
+public:
+    shm_transport_region(int ranks, size_t batch_capacity);
+    ~shm_transport_region();
+
+    shm_transport_region(const shm_transport_region&) = delete;
+    shm_transport_region& operator=(const shm_transport_region&) = delete;
+
+    std::unique_ptr<transport> attach(int rank);
+
+private:
+    friend class shm_transport;
+
+    int ranks_;
+    size_t capacity_;
+    size_t bytes_;
+    void* base_;
+};
+
+#endif
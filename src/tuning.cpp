@@ -0,0 +1,209 @@
+#include "tuning.h"
+#include "csr_graph.h"
+#include "dobfs.h"
+#include "host_info.h"
+#include "parbfs.h"
+#include <parlay/utilities.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bfs_tuning active;
+// Подмена scoped_tuning в этом потоке
+thread_local const bfs_tuning* override_tuning = nullptr;
+
+struct field {
+    const char* key;
+    size_t bfs_tuning::*value;
+};
+
+const field fields[] = {
+    {"expand_grain", &bfs_tuning::expand_grain},
+    {"scan_grain", &bfs_tuning::scan_grain},
+    {"scatter_grain", &bfs_tuning::scatter_grain},
+    {"sequential_below", &bfs_tuning::sequential_below},
+    {"dobfs_alpha", &bfs_tuning::dobfs_alpha},
+    {"dobfs_beta", &bfs_tuning::dobfs_beta},
+};
+
+// Шар BFS вокруг вершины с соседями, вершины перенумерованы по порядку обхода
+csr_graph sample_graph(const csr_graph& graph, size_t limit) {
+    size_t n = graph.size();
+    int root = 0;
+    for (uint64_t i = 0; i < 64 && n > 0; i++) {
+        root = static_cast<int>(parlay::hash64(i) % n);
+        if (graph[root].size() > 0) break;
+    }
+
+    std::vector<int> id(n, -1);
+    std::vector<int> order;
+    if (n > 0) {
+        id[root] = 0;
+        order.push_back(root);
+    }
+    for (size_t head = 0; head < order.size() && order.size() < limit; head++) {
+        for (int k : graph[order[head]]) {
+            if (id[k] == -1 && order.size() < limit) {
+                id[k] = static_cast<int>(order.size());
+                order.push_back(k);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> sample(order.size());
+    for (size_t v = 0; v < order.size(); v++) {
+        for (int k : graph[order[v]]) {
+            if (id[k] >= 0) sample[v].push_back(id[k]);
+        }
+    }
+    return csr_graph(sample);
+}
+
+template <typename Run>
+double median_ms(int runs, Run run) {
+    std::vector<double> times;
+    for (int i = 0; i < runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+}
+
+bool bfs_tuning::operator==(const bfs_tuning& other) const {
+    for (const field& f : fields) {
+        if (this->*f.value != other.*f.value) return false;
+    }
+    return true;
+}
+
+const bfs_tuning& current_tuning() {
+    return override_tuning ? *override_tuning : active;
+}
+
+void set_tuning(const bfs_tuning& tuning) {
+    active = tuning;
+}
+
+scoped_tuning::scoped_tuning(const bfs_tuning& tuning) : tuning_(tuning), previous_(override_tuning) {
+    override_tuning = &tuning_;
+}
+
+scoped_tuning::~scoped_tuning() {
+    override_tuning = previous_;
+}
+
+void save_tuning(const std::string& path, const bfs_tuning& tuning) {
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    std::error_code ec;
+    if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot create tuning file " + path);
+    out << "# parallel_bfs tuning for " << host_name() << "\n";
+    for (const field& f : fields) {
+        out << f.key << " " << tuning.*f.value << "\n";
+    }
+    if (!out) throw std::runtime_error("failed to write tuning file " + path);
+}
+
+bfs_tuning load_tuning(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open tuning file " + path);
+
+    bfs_tuning tuning;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields_in(line);
+        std::string key;
+        long long value = 0;
+        if (!(fields_in >> key >> value) || value < 0) {
+            throw std::runtime_error("malformed tuning line '" + line + "' in " + path);
+        }
+        for (const field& f : fields) {
+            if (key == f.key) tuning.*f.value = static_cast<size_t>(value);
+        }
+    }
+    return tuning;
+}
+
+std::string default_tuning_path() {
+    if (const char* path = std::getenv("PARALLEL_BFS_TUNING")) return path;
+
+    const char* home = std::getenv("HOME");
+    if (home == nullptr) home = std::getenv("USERPROFILE");
+    std::filesystem::path dir = home ? std::filesystem::path(home) / ".parallel_bfs" : std::filesystem::path(".parallel_bfs");
+    return (dir / (host_name() + ".tuning")).string();
+}
+
+bool load_default_tuning() {
+    std::string path = default_tuning_path();
+    if (!std::filesystem::exists(path)) return false;
+    set_tuning(load_tuning(path));
+    return true;
+}
+
+autotune_result autotune(const csr_graph& graph, const autotune_options& options) {
+    autotune_result result;
+    csr_graph sample = sample_graph(graph, options.sample_vertices);
+    result.sample_vertices = sample.size();
+    if (sample.size() == 0) return result;
+
+    auto time_bfs = [&sample, &options] (const bfs_tuning& tuning) {
+        scoped_tuning scope(tuning);
+        return median_ms(options.runs, [&sample] { parallel_bfs(sample, 0); });
+    };
+    auto time_dobfs = [&sample, &options] (const bfs_tuning& tuning) {
+        scoped_tuning scope(tuning);
+        return median_ms(options.runs, [&sample] { direction_optimizing_bfs(sample, 0); });
+    };
+
+    struct candidates {
+        size_t bfs_tuning::*value;
+        std::vector<size_t> values;
+        bool dobfs;
+    };
+    const candidates search[] = {
+        {&bfs_tuning::expand_grain, {0, 8, 64, 512}, false},
+        {&bfs_tuning::scan_grain, {0, 256, 2048, 16384}, false},
+        {&bfs_tuning::scatter_grain, {0, 64, 512, 4096}, false},
+        {&bfs_tuning::sequential_below, {0, 256, 2048, 16384}, false},
+        {&bfs_tuning::dobfs_alpha, {7, 14, 28}, true},
+        {&bfs_tuning::dobfs_beta, {12, 24, 48}, true},
+    };
+
+    // Прогрев: первые обходы платят за страницы и потоки
+    bfs_tuning best;
+    time_bfs(best);
+    result.default_ms = time_bfs(best);
+
+    for (const candidates& c : search) {
+        double best_ms = -1;
+        size_t best_value = best.*c.value;
+        for (size_t value : c.values) {
+            bfs_tuning trial = best;
+            trial.*c.value = value;
+            double ms = c.dobfs ? time_dobfs(trial) : time_bfs(trial);
+            if (best_ms < 0 || ms < best_ms) {
+                best_ms = ms;
+                best_value = value;
+            }
+        }
+        best.*c.value = best_value;
+    }
+
+    result.tuning = best;
+    result.tuned_ms = time_bfs(best);
+    return result;
+}
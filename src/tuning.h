@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class csr_graph;
+
+// Параметры обходов, которые зависят от машины и графа. Гранулярности -
+// число итераций на задачу parlay::parallel_for, 0 - выбор parlay.
+struct bfs_tuning {
+    // Три цикла frontier::expand: обход рёбер фронта, префиксные суммы
+    // (массивы до scan_grain элементов суммируются последовательно) и сборка
+    // следующего фронта
+    size_t expand_grain = 0;
+    size_t scan_grain = 0;
+    size_t scatter_grain = 0;
+    // Фронт меньше этого обрабатывается одной задачей целиком
+    size_t sequential_below = 0;
+    // Пороги переключения direction_optimizing_bfs
+    size_t dobfs_alpha = 14;
+    size_t dobfs_beta = 24;
+
+    bool operator==(const bfs_tuning& other) const;
+};
+
+// Действующие параметры. set_tuning - только между обходами: параметры
+// читает без блокировки поток, ведущий обход.
+const bfs_tuning& current_tuning();
+void set_tuning(const bfs_tuning& tuning);
+
+// Подменяет параметры для обходов, запущенных из этого потока, пока объект
+// жив; другие потоки продолжают видеть set_tuning. Вложенные подмены
+// восстанавливаются в обратном порядке.
+class scoped_tuning {
+public:
+    explicit scoped_tuning(const bfs_tuning& tuning);
+    ~scoped_tuning();
+
+    scoped_tuning(const scoped_tuning&) = delete;
+    scoped_tuning& operator=(const scoped_tuning&) = delete;
+
+private:
+    bfs_tuning tuning_;
+    const bfs_tuning* previous_;
+};
+
+// Профиль хоста: строки "ключ значение", неизвестные ключи пропускаются,
+// отсутствующие остаются по умолчанию. Ошибки - std::runtime_error.
+void save_tuning(const std::string& path, const bfs_tuning& tuning);
+bfs_tuning load_tuning(const std::string& path);
+
+// $PARALLEL_BFS_TUNING или ~/.parallel_bfs/<имя хоста>.tuning
+std::string default_tuning_path();
+
+// Применяет профиль из default_tuning_path(), если он есть (вызывается при
+// запуске). false, если профиля нет; ошибки чтения - как в load_tuning.
+bool load_default_tuning();
+
+struct autotune_options {
+    // Размер выборки: шар BFS вокруг случайной вершины
+    size_t sample_vertices = size_t(1) << 20;
+    // Из стольких замеров на кандидата берётся медиана
+    int runs = 3;
+};
+
+struct autotune_result {
+    bfs_tuning tuning;
+    size_t sample_vertices = 0;
+    // parallel_bfs на выборке до и после подбора
+    double default_ms = 0;
+    double tuned_ms = 0;
+};
+
+// Подбор параметров по одному (покоординатный спуск) короткими обходами
+// выборки графа. Кандидаты применяются через scoped_tuning, поэтому
+// действующие параметры не меняются ни во время подбора, ни после, в том
+// числе для обходов в других потоках.
+autotune_result autotune(const csr_graph& graph, const autotune_options& options = autotune_options());
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// Списки смежности с весами: пары (сосед, вес), веса неотрицательные
+template <typename W>
+using weighted_graph = std::vector<std::vector<std::pair<int, W>>>;